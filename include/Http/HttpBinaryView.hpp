@@ -0,0 +1,42 @@
+#ifndef HTTP_BINARY_VIEW_HPP_INCLUDED
+#define HTTP_BINARY_VIEW_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+
+namespace Http
+{
+    // Bytes sent without being copied into the request, either borrowed from the caller,
+    // who keeps them alive until the response is received, or co-owned through a shared buffer
+    class BinaryView
+    {
+    private:
+        const std::byte* m_data = nullptr;
+        std::size_t m_size = 0;
+        std::shared_ptr<const void> m_owner = {};
+
+    public:
+        BinaryView() = default;
+        BinaryView(const std::byte* data, std::size_t size) : m_data{ data }, m_size{ size } {}
+        BinaryView(const void* data, std::size_t size) : m_data{ static_cast<const std::byte*>(data) }, m_size{ size } {}
+        BinaryView(const TBinary& binary) : m_data{ binary.data() }, m_size{ binary.size() } {}
+        template <typename ContainerType>
+        BinaryView(std::shared_ptr<ContainerType> buffer)
+            : m_data{ reinterpret_cast<const std::byte*>(buffer->data()) }
+            , m_size{ buffer->size() * sizeof(*buffer->data()) }
+            , m_owner{ std::move(buffer) }
+        {
+        }
+
+        virtual ~BinaryView() = default;
+        BinaryView(const BinaryView& other) = default;
+        BinaryView& operator=(const BinaryView& other) = default;
+        BinaryView(BinaryView&& other) = default;
+        BinaryView& operator=(BinaryView&& other) = default;
+
+        const std::byte* data() const { return m_data; }
+        std::size_t size() const { return m_size; }
+        bool isShared() const { return nullptr != m_owner; }
+    };
+}
+
+#endif
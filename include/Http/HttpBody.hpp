@@ -3,10 +3,12 @@
 
 #include "Http/HttpForwards.hpp"
 #include "Http/HttpFormData.hpp"
+#include "Http/HttpBinaryView.hpp"
+#include "Http/HttpLazyJson.hpp"
 
 namespace Http
 {
-    using TContent = std::variant<TEmpty, std::string, nlohmann::json, fs::path, FormData>;
+    using TContent = std::variant<TEmpty, std::string, nlohmann::json, fs::path, FormData, TBinary, BinaryView, LazyJson>;
 
     class Body
     {
@@ -22,9 +24,15 @@ namespace Http
         Body() = default;
         Body(const TEmpty&) : m_content{} {}
         Body(const std::string& text) : m_content{ text } {}
+        Body(std::string&& text) : m_content{ std::move(text) } {}
         Body(const nlohmann::json& json) : m_content(json) {}
+        Body(nlohmann::json&& json) : m_content(std::move(json)) {}
         Body(const fs::path& path) : m_content{ path } {}
         Body(const FormData& form) : m_content{ form } {}
+        Body(const TBinary& binary) : m_content{ binary } {}
+        Body(TBinary&& binary) : m_content{ std::move(binary) } {}
+        Body(const BinaryView& view) : m_content{ view } {}
+        Body(const LazyJson& json) : m_content{ json } {}
         template <typename ContentType>
         Body(const ContentType& content) : m_content(nlohmann::json(content)) {}
 
@@ -36,17 +44,44 @@ namespace Http
 
         Body &operator=(const TEmpty&) { m_content = TEmpty{}; return *this; }
         Body &operator=(const std::string& text) { m_content = text; return *this; }
+        Body &operator=(std::string&& text) { m_content = std::move(text); return *this; }
         Body &operator=(const nlohmann::json& json) { m_content = json; return *this; }
+        Body &operator=(nlohmann::json&& json) { m_content = std::move(json); return *this; }
         Body &operator=(const fs::path& path) { m_content = path; return *this; }
         Body &operator=(const FormData& form) { m_content = form; return *this; }
+        Body &operator=(const TBinary& binary) { m_content = binary; return *this; }
+        Body &operator=(TBinary&& binary) { m_content = std::move(binary); return *this; }
+        Body &operator=(const BinaryView& view) { m_content = view; return *this; }
+        Body &operator=(const LazyJson& json) { m_content = json; return *this; }
         template <typename ContentType>
         Body &operator=(const ContentType& content) { m_content = nlohmann::json(content); return *this; }
 
         const TContent &content() const { return m_content; }
         const std::string &text() const { return std::get<std::string>(m_content); }
-        const nlohmann::json &json() const { return std::get<nlohmann::json>(m_content); }
+        // A received JSON body is only parsed here, on first access
+        const nlohmann::json &json() const
+        {
+            if (auto lazy = std::get_if<LazyJson>(&m_content)) return lazy->json();
+            return std::get<nlohmann::json>(m_content);
+        }
         const fs::path &path() const { return std::get<fs::path>(m_content); }
         const FormData &form() const { return std::get<FormData>(m_content); }
+        const TBinary &binary() const { return std::get<TBinary>(m_content); }
+        const BinaryView &binaryView() const { return std::get<BinaryView>(m_content); }
+
+        // Bytes as received or given, without any parsing: text, JSON still unparsed and binary bodies
+        std::string_view raw() const
+        {
+            auto visitor = overloaded{
+                [](const auto&) -> std::string_view { throw std::bad_variant_access{}; },
+                [](const std::string &arg) -> std::string_view { return arg; },
+                [](const LazyJson &arg) -> std::string_view { return arg.raw(); },
+                [](const TBinary &arg) -> std::string_view { return { reinterpret_cast<const char*>(arg.data()), arg.size() }; },
+                [](const BinaryView &arg) -> std::string_view { return { reinterpret_cast<const char*>(arg.data()), arg.size() }; }
+            };
+
+            return std::visit(visitor, m_content);
+        }
         template <typename ContentType>
         ContentType get() const { return json().get<ContentType>(); }
 
@@ -62,7 +97,7 @@ namespace Http
 
         constexpr bool isJson() const
         {
-            return std::holds_alternative<nlohmann::json>(m_content);
+            return std::holds_alternative<nlohmann::json>(m_content) || std::holds_alternative<LazyJson>(m_content);
         }
 
         constexpr bool isPath() const
@@ -75,6 +110,16 @@ namespace Http
             return std::holds_alternative<FormData>(m_content);
         }
 
+        constexpr bool isBinary() const
+        {
+            return std::holds_alternative<TBinary>(m_content);
+        }
+
+        constexpr bool isBinaryView() const
+        {
+            return std::holds_alternative<BinaryView>(m_content);
+        }
+
         bool save(const fs::path &path) const
         {
             auto visitor = overloaded{
@@ -104,6 +149,15 @@ namespace Http
                 [&path](const FormData&) {
                     //TODO
                     return false;
+                },
+                [this, &path](const TBinary &arg) {
+                    return saveData(std::string_view{ reinterpret_cast<const char*>(arg.data()), arg.size() }, path, std::ios::binary);
+                },
+                [this, &path](const BinaryView &arg) {
+                    return saveData(std::string_view{ reinterpret_cast<const char*>(arg.data()), arg.size() }, path, std::ios::binary);
+                },
+                [this, &path](const LazyJson &arg) {
+                    return saveData(arg.raw(), path);
                 }
             };
 
@@ -111,7 +165,7 @@ namespace Http
         }
 
     private:
-        bool saveData(const std::string& data, const fs::path& path) const
+        bool saveData(std::string_view data, const fs::path& path, std::ios::openmode mode = {}) const
         {
             if (path.has_parent_path())
             {
@@ -120,7 +174,7 @@ namespace Http
                 if (ec) return false;
             }
 
-            std::ofstream file{ path.string() };
+            std::ofstream file{ path.string(), std::ios::out | mode };
             if (false == file.is_open()) return false;
 
             file << data;
@@ -0,0 +1,18 @@
+#ifndef HTTP_CACHE_HPP_INCLUDED
+#define HTTP_CACHE_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+
+namespace Http
+{
+    struct CacheStats
+    {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t revalidations = 0;
+        std::size_t entries = 0;
+        std::size_t bytes = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef HTTP_CHUNKED_UPLOAD_HPP_INCLUDED
+#define HTTP_CHUNKED_UPLOAD_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+#include "Http/HttpOptions.hpp"
+
+namespace Http
+{
+    // Splits a file into multipart chunks sent concurrently, each one along with
+    // chunkIndex, chunkCount, chunkOffset and totalSize form fields
+    class ChunkedUpload
+    {
+    private:
+        std::size_t m_chunkSize = DefaultChunkSize;
+        unsigned int m_parallelism = DefaultParallelism;
+        unsigned int m_maxAttempts = DefaultMaxAttempts;
+        std::string m_field = DefaultField;
+        boost::beast::http::verb m_verb = boost::beast::http::verb::post;
+        std::optional<TProgressCb> m_progress = {};
+        Options m_options = {};
+
+    public:
+        static constexpr std::size_t DefaultChunkSize = 8 << 20;
+        static constexpr unsigned int DefaultParallelism = 4;
+        static constexpr unsigned int DefaultMaxAttempts = 3;
+        static constexpr char const* DefaultField = "file";
+
+    public:
+        inline std::size_t chunkSize() const { return m_chunkSize; }
+        inline ChunkedUpload& chunkSize(std::size_t chunkSize)
+        {
+            m_chunkSize = std::max<std::size_t>(1, chunkSize);
+            return *this;
+        }
+
+        inline unsigned int parallelism() const { return m_parallelism; }
+        inline ChunkedUpload& parallelism(unsigned int parallelism)
+        {
+            m_parallelism = std::max(1u, parallelism);
+            return *this;
+        }
+
+        inline unsigned int maxAttempts() const { return m_maxAttempts; }
+        inline ChunkedUpload& maxAttempts(unsigned int maxAttempts)
+        {
+            m_maxAttempts = std::max(1u, maxAttempts);
+            return *this;
+        }
+
+        inline const std::string& field() const { return m_field; }
+        inline ChunkedUpload& field(const std::string& field)
+        {
+            m_field = field;
+            return *this;
+        }
+
+        inline boost::beast::http::verb verb() const { return m_verb; }
+        inline ChunkedUpload& verb(boost::beast::http::verb verb)
+        {
+            m_verb = verb;
+            return *this;
+        }
+
+        // Called with the file size and the number of file bytes sent so far, across all chunks
+        inline const std::optional<TProgressCb>& progress() const { return m_progress; }
+        inline ChunkedUpload& progress(const TProgressCb& progress)
+        {
+            m_progress = progress;
+            return *this;
+        }
+
+        // Options applied to every chunk request
+        inline const Options& options() const { return m_options; }
+        inline ChunkedUpload& options(const Options& options)
+        {
+            m_options = options;
+            return *this;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef HTTP_CIRCUIT_BREAKER_POLICY_HPP_INCLUDED
+#define HTTP_CIRCUIT_BREAKER_POLICY_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+
+namespace Http
+{
+    class CircuitBreakerPolicy
+    {
+    private:
+        double m_failureRatio = DefaultFailureRatio;
+        unsigned int m_slowCallThreshold = DefaultSlowCallThreshold;
+        double m_slowCallRatio = DefaultSlowCallRatio;
+        unsigned int m_minCalls = DefaultMinCalls;
+        unsigned int m_windowSize = DefaultWindowSize;
+        unsigned int m_openDuration = DefaultOpenDuration;
+        unsigned int m_halfOpenProbes = DefaultHalfOpenProbes;
+
+    public:
+        static constexpr double DefaultFailureRatio = 0.5;
+        static constexpr unsigned int DefaultSlowCallThreshold = 10000;
+        static constexpr double DefaultSlowCallRatio = 1.0;
+        static constexpr unsigned int DefaultMinCalls = 10;
+        static constexpr unsigned int DefaultWindowSize = 20;
+        static constexpr unsigned int DefaultOpenDuration = 5000;
+        static constexpr unsigned int DefaultHalfOpenProbes = 1;
+
+    public:
+        inline double failureRatio() const { return m_failureRatio; }
+        inline CircuitBreakerPolicy& failureRatio(double failureRatio)
+        {
+            m_failureRatio = failureRatio;
+            return *this;
+        }
+
+        inline unsigned int slowCallThreshold() const { return m_slowCallThreshold; }
+        inline CircuitBreakerPolicy& slowCallThreshold(unsigned int slowCallThreshold)
+        {
+            m_slowCallThreshold = slowCallThreshold;
+            return *this;
+        }
+
+        inline double slowCallRatio() const { return m_slowCallRatio; }
+        inline CircuitBreakerPolicy& slowCallRatio(double slowCallRatio)
+        {
+            m_slowCallRatio = slowCallRatio;
+            return *this;
+        }
+
+        inline unsigned int minCalls() const { return m_minCalls; }
+        inline CircuitBreakerPolicy& minCalls(unsigned int minCalls)
+        {
+            m_minCalls = minCalls;
+            return *this;
+        }
+
+        inline unsigned int windowSize() const { return m_windowSize; }
+        inline CircuitBreakerPolicy& windowSize(unsigned int windowSize)
+        {
+            m_windowSize = windowSize;
+            return *this;
+        }
+
+        inline unsigned int openDuration() const { return m_openDuration; }
+        inline CircuitBreakerPolicy& openDuration(unsigned int openDuration)
+        {
+            m_openDuration = openDuration;
+            return *this;
+        }
+
+        inline unsigned int halfOpenProbes() const { return m_halfOpenProbes; }
+        inline CircuitBreakerPolicy& halfOpenProbes(unsigned int halfOpenProbes)
+        {
+            m_halfOpenProbes = halfOpenProbes;
+            return *this;
+        }
+    };
+}
+
+#endif
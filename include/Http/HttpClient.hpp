@@ -17,7 +17,11 @@ namespace Http
     public:
         Client() = delete;
         Client(const std::string &url, Options options = {})
-            : m_clientImpl{std::make_shared<detail::ClientImpl>(url, options)}
+            : Client{std::vector<std::string>{url}, options}
+        {
+        }
+        Client(const std::vector<std::string> &urls, Options options = {})
+            : m_clientImpl{std::make_shared<detail::ClientImpl>(urls, options)}
         {
             if (nullptr == m_clientImpl)
             {
@@ -84,6 +88,23 @@ namespace Http
         {
             m_clientImpl->cancelAll();
         }
+
+        // Uploads a file as concurrent multipart chunks, answering with the last chunk response or the first failure
+        std::shared_future<Response> upload(const std::string &target, const fs::path &path, const ChunkedUpload &upload = {}) const
+        {
+            return m_clientImpl->upload(target, path, upload);
+        }
+
+        CacheStats cacheStats() const
+        {
+            return m_clientImpl->cacheStats();
+        }
+
+        // Arena blocks obtained from the heap so far, the requests of the client recycling them
+        std::size_t arenaBlocks() const
+        {
+            return m_clientImpl->arenaPool()->allocated();
+        }
     };
 }
 
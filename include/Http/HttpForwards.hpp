@@ -10,13 +10,29 @@
 #include <boost/asio/executor_work_guard.hpp>
 #include <boost/beast.hpp>
 #include <boost/beast/ssl.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/random_generator.hpp>
 #include <boost/uuid/uuid_io.hpp>
 
+#if defined(__linux__)
+#include <fcntl.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
 #include <future>
 #include <functional>
 #include <fstream>
+#include <limits>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -25,10 +41,13 @@
 #include <map>
 #include <variant>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <optional>
+#include <random>
 #include <regex>
 #include <type_traits>
+#include <unordered_map>
 #include <filesystem>
 
 namespace fs = std::filesystem;
@@ -83,18 +102,24 @@ namespace Http
 
     namespace detail
     {
+        template <typename T>
+        class ArenaAllocator;
+
+        using TFieldsAllocator = ArenaAllocator<char>;
+        using TFields = boost::beast::http::basic_fields<TFieldsAllocator>;
+
         template <typename Body>
-        using TRequest = boost::beast::http::request<Body>;
+        using TRequest = boost::beast::http::request<Body, TFields>;
         template <typename Body>
         using TRequestPtr = std::shared_ptr<TRequest<Body>>;
 
         template <typename Body>
-        using TResponseParser = boost::beast::http::response_parser<Body>;
+        using TResponseParser = boost::beast::http::response_parser<Body, TFieldsAllocator>;
         template <typename Body>
-        using TResponseParserPtr = std::shared_ptr<boost::beast::http::response_parser<Body>>;
+        using TResponseParserPtr = std::shared_ptr<TResponseParser<Body>>;
 
         template <typename Body>
-        using TRequestSerializer = boost::beast::http::request_serializer<Body>;
+        using TRequestSerializer = boost::beast::http::request_serializer<Body, TFields>;
         template <typename Body>
         using TRequestSerializerPtr = std::shared_ptr<TRequestSerializer<Body>>;
 
@@ -105,6 +130,8 @@ namespace Http
         class SessionBase;
 
         class HttpFile;
+        class ResponseCache;
+        class DiskCache;
 
         using TClientImplPtr = std::shared_ptr<const ClientImpl>;
         using TClientImplWeakPtr = std::weak_ptr<const ClientImpl>;
@@ -113,6 +140,7 @@ namespace Http
 
     struct Empty {};
     using TEmpty = Empty;
+    using TBinary = std::vector<std::byte>;
 }
 
 #endif
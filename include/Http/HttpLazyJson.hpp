@@ -0,0 +1,58 @@
+#ifndef HTTP_LAZY_JSON_HPP_INCLUDED
+#define HTTP_LAZY_JSON_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+#include "Http/detail/HttpSimdJson.hpp"
+
+namespace Http
+{
+    // JSON kept as received and parsed on first access only, copies share both the text and the parsed document
+    class LazyJson
+    {
+    private:
+        struct State
+        {
+            std::string raw;
+            std::once_flag once;
+            std::atomic<bool> parsed{ false };
+            nlohmann::json json;
+        };
+
+        std::shared_ptr<State> m_state;
+
+    public:
+        LazyJson() : m_state{ std::make_shared<State>() } {}
+        explicit LazyJson(std::string raw) : m_state{ std::make_shared<State>() }
+        {
+            m_state->raw = std::move(raw);
+        }
+
+        virtual ~LazyJson() = default;
+        LazyJson(const LazyJson& other) = default;
+        LazyJson& operator=(const LazyJson& other) = default;
+        LazyJson(LazyJson&& other) = default;
+        LazyJson& operator=(LazyJson&& other) = default;
+
+        const std::string& raw() const { return m_state->raw; }
+        // The text is never modified once received, so it can be shared with a sender outliving this copy
+        std::shared_ptr<const std::string> shared() const { return { m_state, &m_state->raw }; }
+        bool isParsed() const { return m_state->parsed; }
+
+        // Invalid JSON gives a null document, as an eagerly parsed body does
+        const nlohmann::json& json() const
+        {
+            std::call_once(m_state->once, [state = m_state.get()]()
+            {
+                state->json = detail::parseJson(state->raw);
+                state->parsed = true;
+            });
+
+            return m_state->json;
+        }
+
+        template <typename ContentType>
+        ContentType get() const { return json().get<ContentType>(); }
+    };
+}
+
+#endif
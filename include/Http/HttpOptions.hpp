@@ -3,11 +3,26 @@
 
 #include "Http/HttpForwards.hpp"
 #include "Http/HttpAuth.hpp"
+#include "Http/HttpRetry.hpp"
+#include "Http/HttpCircuitBreakerPolicy.hpp"
 
 namespace Http
 {
     using TProgressCb = std::function<void(std::size_t, std::size_t)>;
 
+    enum class LoadBalancing
+    {
+        RoundRobin,
+        LeastOutstanding,
+        PowerOfTwoChoices
+    };
+
+    struct ByteRange
+    {
+        std::uint64_t first = 0;
+        std::optional<std::uint64_t> last = {};
+    };
+
     class Options
     {
     private:
@@ -15,6 +30,7 @@ namespace Http
         std::optional<fs::path> m_tempDir = {};
         std::optional<fs::path> m_fileOut = {};
         std::optional<bool> m_fileAppend = {};
+        std::optional<bool> m_atomicFileOut = {};
         std::optional<unsigned long> m_bodyLimit = {};
         std::optional<std::string> m_proxy = {};
         std::optional<std::string> m_auth = {};
@@ -27,11 +43,47 @@ namespace Http
         std::optional<unsigned int> m_nbThreads = {};
         std::optional<std::size_t> m_readBufferSize = {};
         std::optional<std::size_t> m_writeBufferSize = {};
+        std::optional<RetryPolicy> m_retryPolicy = {};
+        std::optional<double> m_retryBudget = {};
+        std::optional<unsigned int> m_hedgeDelay = {};
+        std::optional<double> m_hedgePercentile = {};
+        std::optional<LoadBalancing> m_loadBalancing = {};
+        std::optional<bool> m_resolveAll = {};
+        std::optional<unsigned int> m_ejectAfter = {};
+        std::optional<unsigned int> m_ejectionTime = {};
+        std::optional<bool> m_happyEyeballs = {};
+        std::optional<unsigned int> m_connectionAttemptDelay = {};
+        std::optional<CircuitBreakerPolicy> m_circuitBreaker = {};
+        std::optional<double> m_maxRequestRate = {};
+        std::optional<double> m_maxByteRate = {};
+        std::optional<std::size_t> m_maxQueuedRequests = {};
+        std::optional<double> m_maxUploadRate = {};
+        std::optional<double> m_maxDownloadRate = {};
+        std::optional<double> m_maxTotalUploadRate = {};
+        std::optional<double> m_maxTotalDownloadRate = {};
+        std::optional<std::size_t> m_cacheSize = {};
+        std::optional<fs::path> m_cacheDir = {};
+        std::optional<std::size_t> m_cacheDirSize = {};
+        std::optional<bool> m_singleFlight = {};
+        std::optional<std::vector<std::string>> m_singleFlightHeaders = {};
+        std::optional<bool> m_resume = {};
+        std::optional<unsigned int> m_parallelRanges = {};
+        std::optional<ByteRange> m_range = {};
+        std::optional<bool> m_memoryMap = {};
+        std::optional<std::size_t> m_memoryBodyLimit = {};
+        std::optional<std::map<std::string, std::string>> m_validators = {};
 
     public:
         static constexpr double DefaultProgressStep = 0.01;
         static constexpr unsigned int DefaultNbThreads = 1;
         static constexpr std::size_t DefaultBufferSize = 64_KiB;
+        static constexpr std::size_t DefaultMemoryBodyLimit = 64_KiB;
+        static constexpr unsigned int DefaultHedgeDelay = 50;
+        static constexpr unsigned int DefaultEjectAfter = 5;
+        static constexpr unsigned int DefaultEjectionTime = 10000;
+        static constexpr unsigned int DefaultConnectionAttemptDelay = 250;
+        static constexpr std::size_t DefaultMaxQueuedRequests = 100;
+        static constexpr std::size_t DefaultCacheDirSize = 1 << 30;
 
     public:
         inline const std::optional<fs::path>& ca() const { return m_ca; }
@@ -62,6 +114,15 @@ namespace Http
             return *this;
         }
 
+        // Downloads fileOut under a temporary name renamed on completion, so that no partial file is ever observed.
+        // Ignored when appending or writing ranges, which need the existing file
+        inline const std::optional<bool>& atomicFileOut() const { return m_atomicFileOut; }
+        inline Options& atomicFileOut(bool atomicFileOut)
+        {
+            m_atomicFileOut = atomicFileOut;
+            return *this;
+        }
+
         inline const std::optional<unsigned long>& bodyLimit() const { return m_bodyLimit; }
         inline Options& bodyLimit(const unsigned long bodyLimit)
         {
@@ -165,6 +226,218 @@ namespace Http
             return *this;
         }
 
+        inline const std::optional<RetryPolicy>& retryPolicy() const { return m_retryPolicy; }
+        inline Options& retryPolicy(const RetryPolicy& retryPolicy)
+        {
+            m_retryPolicy = retryPolicy;
+            return *this;
+        }
+
+        inline const std::optional<double>& retryBudget() const { return m_retryBudget; }
+        inline Options& retryBudget(double retryBudget)
+        {
+            m_retryBudget = retryBudget;
+            return *this;
+        }
+
+        inline const std::optional<unsigned int>& hedgeDelay() const { return m_hedgeDelay; }
+        inline Options& hedgeDelay(unsigned int hedgeDelay)
+        {
+            m_hedgeDelay = hedgeDelay;
+            return *this;
+        }
+
+        inline const std::optional<double>& hedgePercentile() const { return m_hedgePercentile; }
+        inline Options& hedgePercentile(double hedgePercentile)
+        {
+            m_hedgePercentile = hedgePercentile;
+            return *this;
+        }
+
+        inline bool hedged() const { return m_hedgeDelay.has_value() || m_hedgePercentile.has_value(); }
+
+        inline const std::optional<LoadBalancing>& loadBalancing() const { return m_loadBalancing; }
+        inline Options& loadBalancing(LoadBalancing loadBalancing)
+        {
+            m_loadBalancing = loadBalancing;
+            return *this;
+        }
+
+        inline const std::optional<bool>& resolveAll() const { return m_resolveAll; }
+        inline Options& resolveAll(bool resolveAll)
+        {
+            m_resolveAll = resolveAll;
+            return *this;
+        }
+
+        inline const std::optional<unsigned int>& ejectAfter() const { return m_ejectAfter; }
+        inline Options& ejectAfter(unsigned int ejectAfter)
+        {
+            m_ejectAfter = ejectAfter;
+            return *this;
+        }
+
+        inline const std::optional<unsigned int>& ejectionTime() const { return m_ejectionTime; }
+        inline Options& ejectionTime(unsigned int ejectionTime)
+        {
+            m_ejectionTime = ejectionTime;
+            return *this;
+        }
+
+        inline const std::optional<bool>& happyEyeballs() const { return m_happyEyeballs; }
+        inline Options& happyEyeballs(bool happyEyeballs)
+        {
+            m_happyEyeballs = happyEyeballs;
+            return *this;
+        }
+
+        inline const std::optional<unsigned int>& connectionAttemptDelay() const { return m_connectionAttemptDelay; }
+        inline Options& connectionAttemptDelay(unsigned int connectionAttemptDelay)
+        {
+            m_connectionAttemptDelay = connectionAttemptDelay;
+            return *this;
+        }
+
+        inline const std::optional<CircuitBreakerPolicy>& circuitBreaker() const { return m_circuitBreaker; }
+        inline Options& circuitBreaker(const CircuitBreakerPolicy& circuitBreaker)
+        {
+            m_circuitBreaker = circuitBreaker;
+            return *this;
+        }
+
+        inline const std::optional<double>& maxRequestRate() const { return m_maxRequestRate; }
+        inline Options& maxRequestRate(double requestsPerSecond)
+        {
+            m_maxRequestRate = requestsPerSecond;
+            return *this;
+        }
+
+        inline const std::optional<double>& maxByteRate() const { return m_maxByteRate; }
+        inline Options& maxByteRate(double bytesPerSecond)
+        {
+            m_maxByteRate = bytesPerSecond;
+            return *this;
+        }
+
+        inline const std::optional<std::size_t>& maxQueuedRequests() const { return m_maxQueuedRequests; }
+        inline Options& maxQueuedRequests(std::size_t maxQueuedRequests)
+        {
+            m_maxQueuedRequests = maxQueuedRequests;
+            return *this;
+        }
+
+        inline const std::optional<double>& maxUploadRate() const { return m_maxUploadRate; }
+        inline Options& maxUploadRate(double bytesPerSecond)
+        {
+            m_maxUploadRate = bytesPerSecond;
+            return *this;
+        }
+
+        inline const std::optional<double>& maxDownloadRate() const { return m_maxDownloadRate; }
+        inline Options& maxDownloadRate(double bytesPerSecond)
+        {
+            m_maxDownloadRate = bytesPerSecond;
+            return *this;
+        }
+
+        inline const std::optional<double>& maxTotalUploadRate() const { return m_maxTotalUploadRate; }
+        inline Options& maxTotalUploadRate(double bytesPerSecond)
+        {
+            m_maxTotalUploadRate = bytesPerSecond;
+            return *this;
+        }
+
+        inline const std::optional<double>& maxTotalDownloadRate() const { return m_maxTotalDownloadRate; }
+        inline Options& maxTotalDownloadRate(double bytesPerSecond)
+        {
+            m_maxTotalDownloadRate = bytesPerSecond;
+            return *this;
+        }
+
+        inline const std::optional<std::size_t>& cacheSize() const { return m_cacheSize; }
+        inline Options& cacheSize(std::size_t bytes)
+        {
+            m_cacheSize = bytes;
+            return *this;
+        }
+
+        inline const std::optional<fs::path>& cacheDir() const { return m_cacheDir; }
+        inline Options& cacheDir(const fs::path& cacheDir)
+        {
+            m_cacheDir = cacheDir;
+            return *this;
+        }
+
+        inline const std::optional<std::size_t>& cacheDirSize() const { return m_cacheDirSize; }
+        inline Options& cacheDirSize(std::size_t bytes)
+        {
+            m_cacheDirSize = bytes;
+            return *this;
+        }
+
+        inline const std::optional<bool>& singleFlight() const { return m_singleFlight; }
+        inline Options& singleFlight(bool singleFlight)
+        {
+            m_singleFlight = singleFlight;
+            return *this;
+        }
+
+        // Request headers telling identical requests apart, all of them when unset; credentials always count
+        inline const std::optional<std::vector<std::string>>& singleFlightHeaders() const { return m_singleFlightHeaders; }
+        inline Options& singleFlightHeaders(const std::vector<std::string>& headers)
+        {
+            m_singleFlightHeaders = headers;
+            return *this;
+        }
+
+        // Resumes a download into fileOut from its current size
+        inline const std::optional<bool>& resume() const { return m_resume; }
+        inline Options& resume(bool resume)
+        {
+            m_resume = resume;
+            return *this;
+        }
+
+        // Splits a download into fileOut across as many byte ranges fetched concurrently
+        inline const std::optional<unsigned int>& parallelRanges() const { return m_parallelRanges; }
+        inline Options& parallelRanges(unsigned int parallelRanges)
+        {
+            m_parallelRanges = parallelRanges;
+            return *this;
+        }
+
+        // Fetches a single byte range, written at the same offset of fileOut
+        inline const std::optional<ByteRange>& range() const { return m_range; }
+        inline Options& range(const ByteRange& range)
+        {
+            m_range = range;
+            return *this;
+        }
+
+        // Uploads file bodies straight from a read-only mapping of the file instead of read() copies
+        inline const std::optional<bool>& memoryMap() const { return m_memoryMap; }
+        inline Options& memoryMap(bool memoryMap)
+        {
+            m_memoryMap = memoryMap;
+            return *this;
+        }
+
+        // Binary responses with a Content-Length up to this size are kept in memory instead of a temp file, 0 always spills
+        inline const std::optional<std::size_t>& memoryBodyLimit() const { return m_memoryBodyLimit; }
+        inline Options& memoryBodyLimit(std::size_t memoryBodyLimit)
+        {
+            m_memoryBodyLimit = memoryBodyLimit;
+            return *this;
+        }
+
+        // Conditional headers revalidating a cached response, set per attempt by the client
+        inline const std::optional<std::map<std::string, std::string>>& validators() const { return m_validators; }
+        inline Options& validators(const std::map<std::string, std::string>& validators)
+        {
+            m_validators = validators;
+            return *this;
+        }
+
         inline Options operator+(const Options& other) const
         {
             Options result = *this;
@@ -172,6 +445,7 @@ namespace Http
             if (other.tempDir().has_value()) result.tempDir(other.tempDir().value());
             if (other.fileOut().has_value()) result.fileOut(other.fileOut().value());
             if (other.fileAppend().has_value()) result.fileAppend(other.fileAppend().value());
+            if (other.atomicFileOut().has_value()) result.atomicFileOut(other.atomicFileOut().value());
             if (other.bodyLimit().has_value()) result.bodyLimit(other.bodyLimit().value());
             if (other.proxy().has_value()) result.proxy(other.proxy().value());
             if (other.auth().has_value()) result.auth(other.auth().value());
@@ -184,6 +458,35 @@ namespace Http
             if (other.nbThreads().has_value()) result.nbThreads(other.nbThreads().value());
             if (other.readBufferSize().has_value()) result.readBufferSize(other.readBufferSize().value());
             if (other.writeBufferSize().has_value()) result.writeBufferSize(other.writeBufferSize().value());
+            if (other.retryPolicy().has_value()) result.retryPolicy(other.retryPolicy().value());
+            if (other.retryBudget().has_value()) result.retryBudget(other.retryBudget().value());
+            if (other.hedgeDelay().has_value()) result.hedgeDelay(other.hedgeDelay().value());
+            if (other.hedgePercentile().has_value()) result.hedgePercentile(other.hedgePercentile().value());
+            if (other.loadBalancing().has_value()) result.loadBalancing(other.loadBalancing().value());
+            if (other.resolveAll().has_value()) result.resolveAll(other.resolveAll().value());
+            if (other.ejectAfter().has_value()) result.ejectAfter(other.ejectAfter().value());
+            if (other.ejectionTime().has_value()) result.ejectionTime(other.ejectionTime().value());
+            if (other.happyEyeballs().has_value()) result.happyEyeballs(other.happyEyeballs().value());
+            if (other.connectionAttemptDelay().has_value()) result.connectionAttemptDelay(other.connectionAttemptDelay().value());
+            if (other.circuitBreaker().has_value()) result.circuitBreaker(other.circuitBreaker().value());
+            if (other.maxRequestRate().has_value()) result.maxRequestRate(other.maxRequestRate().value());
+            if (other.maxByteRate().has_value()) result.maxByteRate(other.maxByteRate().value());
+            if (other.maxQueuedRequests().has_value()) result.maxQueuedRequests(other.maxQueuedRequests().value());
+            if (other.maxUploadRate().has_value()) result.maxUploadRate(other.maxUploadRate().value());
+            if (other.maxDownloadRate().has_value()) result.maxDownloadRate(other.maxDownloadRate().value());
+            if (other.maxTotalUploadRate().has_value()) result.maxTotalUploadRate(other.maxTotalUploadRate().value());
+            if (other.maxTotalDownloadRate().has_value()) result.maxTotalDownloadRate(other.maxTotalDownloadRate().value());
+            if (other.cacheSize().has_value()) result.cacheSize(other.cacheSize().value());
+            if (other.cacheDir().has_value()) result.cacheDir(other.cacheDir().value());
+            if (other.cacheDirSize().has_value()) result.cacheDirSize(other.cacheDirSize().value());
+            if (other.singleFlight().has_value()) result.singleFlight(other.singleFlight().value());
+            if (other.singleFlightHeaders().has_value()) result.singleFlightHeaders(other.singleFlightHeaders().value());
+            if (other.resume().has_value()) result.resume(other.resume().value());
+            if (other.parallelRanges().has_value()) result.parallelRanges(other.parallelRanges().value());
+            if (other.range().has_value()) result.range(other.range().value());
+            if (other.memoryMap().has_value()) result.memoryMap(other.memoryMap().value());
+            if (other.memoryBodyLimit().has_value()) result.memoryBodyLimit(other.memoryBodyLimit().value());
+            if (other.validators().has_value()) result.validators(other.validators().value());
 
             return result;
         }
@@ -39,6 +39,14 @@ namespace Http
             return *this;
         }
 
+        // Freezes the start line and the headers set so far into a head serialized once per endpoint.
+        // Headers set afterwards are patched in on each send, along with the body
+        Request &prepare()
+        {
+            m_requestImpl->prepare();
+            return *this;
+        }
+
         const Options &options() const
         {
             return m_requestImpl->m_options;
@@ -72,8 +80,8 @@ namespace Http
         }
 
     private:
-        Request(const std::string &host, const std::string &port, boost::beast::http::verb verb, const std::string &target, detail::TClientImplPtr clientImpl)
-            : m_requestImpl{std::make_shared<detail::RequestImpl>(host, port, verb, target, clientImpl)}, m_clientImpl{clientImpl}
+        Request(boost::beast::http::verb verb, const std::string &target, detail::TClientImplPtr clientImpl)
+            : m_requestImpl{std::make_shared<detail::RequestImpl>(verb, target, clientImpl)}, m_clientImpl{clientImpl}
         {
             if (nullptr == m_requestImpl)
             {
@@ -7,6 +7,7 @@
 #include "Http/detail/HttpFile.hpp"
 #include "Http/detail/empty_body.hpp"
 #include "Http/detail/basic_string_body.hpp"
+#include "Http/detail/basic_binary_body.hpp"
 #include "Http/detail/basic_file_body.hpp"
 #include "Http/detail/basic_multipart_body.hpp"
 
@@ -19,22 +20,43 @@ namespace Http
     static constexpr char const *ContentApplicationOctetStream = "application/octet-stream";
     static constexpr char const *ContentMultipartFormData = "multipart/form-data";
 
+    static constexpr unsigned int StatusCanceled = 499;
+    static constexpr unsigned int StatusRateLimited = 598;
+    static constexpr unsigned int StatusCircuitOpen = 599;
+
     class Response
     {
+    public:
+        using THeaders = std::map<std::string, std::string>;
+
     private:
         template <typename DerivedType>
         friend class detail::SessionBase;
+        friend struct detail::ClientImpl;
+        friend class detail::ResponseCache;
+        friend class detail::DiskCache;
 
         unsigned int m_status = castFromEnum(boost::beast::http::status::unknown);
         std::string m_reason;
+        THeaders m_headers;
         Body m_body;
         fs::path m_tempPath;
+        fs::path m_stagingPath;
 
     public:
         unsigned int status() const { return m_status; }
         const std::string &reason() const { return m_reason; }
         const Body &body() const { return m_body; }
 
+        // Header names are lower-cased, repeated headers are joined with ", ",
+        // except Set-Cookie ones whose dates hold commas, which are joined one per line
+        const THeaders &headers() const { return m_headers; }
+        std::string header(const std::string &name) const
+        {
+            auto it = m_headers.find(boost::algorithm::to_lower_copy(name));
+            return it != m_headers.end() ? it->second : std::string{};
+        }
+
         bool ok() const
         {
             return castFromEnum(boost::beast::http::status::ok) == m_status;
@@ -48,7 +70,7 @@ namespace Http
         Response &operator=(Response &&other) = default;
 
     private:
-        void setContentType(const detail::TEmptyParser &parser)
+        void setContentType(const detail::TEmptyParser &parser, const Options &options)
         {
             auto contentType = parser.get()[boost::beast::http::field::content_type];
 
@@ -64,7 +86,7 @@ namespace Http
             }
             else if (true == boost::algorithm::contains(contentType, ContentApplicationJson))
             {
-                m_body = nlohmann::json{};
+                m_body = LazyJson{};
             }
             else if (true == boost::algorithm::contains(contentType, ContentApplicationXml))
             {
@@ -76,6 +98,12 @@ namespace Http
                 // TODO
                 m_body = FormData{};
             }
+            // Small binary payloads stay in memory, large or unknown ones are streamed to a file
+            else if (false == options.fileOut().has_value() && parser.content_length().has_value() &&
+                     parser.content_length().value() <= options.memoryBodyLimit().value_or(Options::DefaultMemoryBodyLimit))
+            {
+                m_body = TBinary{};
+            }
             else
             {
                 m_body = fs::path{};
@@ -91,19 +119,25 @@ namespace Http
         detail::TStringParserPtr prepare(const std::string &bodyContent, detail::TEmptyParserPtr parser0, const Options &options, boost::beast::error_code &ec)
         {
             ec = {};
-            return std::make_shared<detail::TStringParser>(std::move(*parser0));
+            return detail::allocateShared<detail::TStringParser>(parser0->get().get_allocator(), std::move(*parser0));
         }
 
         detail::TStringParserPtr prepare(const nlohmann::json &bodyContent, detail::TEmptyParserPtr parser0, const Options &options, boost::beast::error_code &ec)
         {
             ec = {};
-            return std::make_shared<detail::TStringParser>(std::move(*parser0));
+            return detail::allocateShared<detail::TStringParser>(parser0->get().get_allocator(), std::move(*parser0));
+        }
+
+        detail::TStringParserPtr prepare(const LazyJson &bodyContent, detail::TEmptyParserPtr parser0, const Options &options, boost::beast::error_code &ec)
+        {
+            ec = {};
+            return detail::allocateShared<detail::TStringParser>(parser0->get().get_allocator(), std::move(*parser0));
         }
 
         detail::TFileParserPtr prepare(const fs::path &bodyContent, detail::TEmptyParserPtr parser0, const Options &options, boost::beast::error_code &ec)
         {
             ec = {};
-            auto parser = std::make_shared<detail::TFileParser>(std::move(*parser0));
+            auto parser = detail::allocateShared<detail::TFileParser>(parser0->get().get_allocator(), std::move(*parser0));
             m_tempPath = options.fileOut().value_or(options.tempDir().value_or(std::filesystem::temp_directory_path()) / boost::uuids::to_string(boost::uuids::random_generator()()));
             detail::FileBody::value_type body;
             boost::beast::file_mode mode = options.fileAppend().value_or(false)
@@ -111,14 +145,40 @@ namespace Http
                                                       ? boost::beast::file_mode::append_existing
                                                       : boost::beast::file_mode::append)
                                                : boost::beast::file_mode::append;
-            body.open(m_tempPath.string().c_str(), mode, ec);
+
+            // A partial answer is written at its offset, a full one replaces the file
+            auto partial = options.range().has_value() && castFromEnum(boost::beast::http::status::partial_content) == parser0->get().result_int();
+            if (options.range().has_value())
+                mode = partial && std::filesystem::exists(m_tempPath) ? boost::beast::file_mode::write_existing : boost::beast::file_mode::write;
+
+            // A partial answer must start at the requested offset, where it gets written
+            if (partial)
+            {
+                auto contentRange = std::string{ parser->get()[boost::beast::http::field::content_range] };
+                if (contentRange.size() <= 6 || 0 != contentRange.rfind("bytes ", 0) || 0 == std::isdigit(static_cast<unsigned char>(contentRange[6])) ||
+                    std::strtoull(contentRange.c_str() + 6, nullptr, 10) != options.range().value().first)
+                {
+                    ec = boost::beast::http::error::bad_value;
+                    return nullptr;
+                }
+            }
+
+            // An atomic download is staged next to its destination so that the final rename stays on one filesystem
+            m_stagingPath.clear();
+            if (options.atomicFileOut().value_or(false) && options.fileOut().has_value() && false == options.fileAppend().value_or(false) && false == options.range().has_value())
+                m_stagingPath = m_tempPath.parent_path() / (m_tempPath.filename().string() + "." + boost::uuids::to_string(boost::uuids::random_generator()()) + ".part");
+
+            body.open((m_stagingPath.empty() ? m_tempPath : m_stagingPath).string().c_str(), mode, ec);
             if (ec)
                 return nullptr;
-            body.seek(body.size(), ec);
+            body.seek(options.range().has_value() ? (partial ? options.range().value().first : 0) : body.size(), ec);
             if (ec)
                 return nullptr;
             if (options.writeBufferSize().has_value())
                 body.buffer_size(options.writeBufferSize().value());
+            // Ranges share their file with concurrent writers, which must not release each other's blocks
+            if (false == options.range().has_value() && parser->content_length().has_value())
+                body.preallocate(parser->content_length().value());
             parser->get().body() = std::move(body);
             return parser;
         }
@@ -129,17 +189,50 @@ namespace Http
             return nullptr;
         }
 
+        detail::TBinaryParserPtr prepare(const TBinary &bodyContent, detail::TEmptyParserPtr parser0, const Options &options, boost::beast::error_code &ec)
+        {
+            ec = {};
+            return detail::allocateShared<detail::TBinaryParser>(parser0->get().get_allocator(), std::move(*parser0));
+        }
+
+        // Responses are never received into borrowed bytes
+        detail::TBinaryParserPtr prepare(const BinaryView &bodyContent, detail::TEmptyParserPtr parser0, const Options &options, boost::beast::error_code &ec)
+        {
+            ec = {};
+            return nullptr;
+        }
+
         template <typename BodyType>
         void getStatus(detail::TResponseParserPtr<BodyType> &parser)
         {
             m_status = parser->get().result_int();
             m_reason = std::string{parser->get().reason()};
+
+            m_headers.clear();
+            for (const auto &field : parser->get())
+            {
+                auto &value = m_headers[boost::algorithm::to_lower_copy(std::string{field.name_string()})];
+                if (!value.empty()) value += boost::beast::http::field::set_cookie == field.name() ? "\n" : ", ";
+                value += std::string{field.value()};
+            }
         }
 
         void handleCancel()
         {
             m_reason = "Request canceled";
-            m_status = 499;
+            m_status = StatusCanceled;
+        }
+
+        void handleRateLimited()
+        {
+            m_reason = "Too many requests queued by the client";
+            m_status = StatusRateLimited;
+        }
+
+        void handleCircuitOpen(const std::string &url)
+        {
+            m_reason = "Circuit open for " + url;
+            m_status = StatusCircuitOpen;
         }
 
         void handleError(const boost::beast::error_code& ec, const std::string& reason)
@@ -167,12 +260,9 @@ namespace Http
                 {
                     bodyContent = std::move(parser->get().body());
                 },
-                [&parser](nlohmann::json &bodyContent)
+                [&parser](LazyJson &bodyContent)
                 {
-                    if (true == nlohmann::json::accept(parser->get().body()))
-                        bodyContent = std::move(nlohmann::json::parse(parser->get().body()));
-                    else
-                        bodyContent = nullptr;
+                    bodyContent = LazyJson{ std::move(parser->get().body()) };
                 }};
             std::visit(visitor, m_body.m_content);
         }
@@ -183,6 +273,15 @@ namespace Http
             if (parser != nullptr)
                 parser->get().body().close();
 
+            if (!m_stagingPath.empty())
+            {
+                // Keeps the staged file when it can't take its final name
+                std::error_code ec;
+                std::filesystem::rename(m_stagingPath, m_tempPath, ec);
+                if (ec) m_tempPath = m_stagingPath;
+                m_stagingPath.clear();
+            }
+
             m_body.m_content = m_tempPath;
         }
 
@@ -191,6 +290,12 @@ namespace Http
             // TODO
         }
 
+        void handleResponse(detail::TResponseParserPtr<detail::BinaryBody> &parser)
+        {
+            getStatus(parser);
+            m_body.m_content = std::move(parser->get().body());
+        }
+
         template <typename BodyType>
         void handleCancel(detail::TResponseParserPtr<BodyType> &parser)
         {
@@ -217,8 +322,15 @@ namespace Http
         void handleError(detail::TResponseParserPtr<detail::FileBody> &parser, const boost::beast::error_code &ec, const std::string &reason)
         {
             handleError(ec, reason);
-            if (parser != nullptr)
-                parser->get().body().close();
+            if (parser == nullptr) return;
+
+            // A failed atomic download leaves nothing behind, any other keeps what was received for a resume
+            std::error_code ignored;
+            if (!m_stagingPath.empty())
+                parser->get().body().remove(ignored);
+            else
+                parser->get().body().truncate();
+            m_stagingPath.clear();
         }
     };
 }
@@ -0,0 +1,116 @@
+#ifndef HTTP_RETRY_HPP_INCLUDED
+#define HTTP_RETRY_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+
+namespace Http
+{
+    class RetryPolicy
+    {
+    private:
+        using TStatuses = std::vector<unsigned int>;
+
+        unsigned int m_maxAttempts = DefaultMaxAttempts;
+        unsigned int m_baseDelay = DefaultBaseDelay;
+        unsigned int m_maxDelay = DefaultMaxDelay;
+        bool m_retryOnConnectErrors = true;
+        TStatuses m_retryStatuses = { 502, 503, 504 };
+        bool m_idempotentOnly = true;
+        bool m_honourRetryAfter = true;
+
+    public:
+        static constexpr unsigned int DefaultMaxAttempts = 3;
+        static constexpr unsigned int DefaultBaseDelay = 100;
+        static constexpr unsigned int DefaultMaxDelay = 10000;
+
+    public:
+        inline unsigned int maxAttempts() const { return m_maxAttempts; }
+        inline RetryPolicy& maxAttempts(unsigned int maxAttempts)
+        {
+            m_maxAttempts = maxAttempts;
+            return *this;
+        }
+
+        inline unsigned int baseDelay() const { return m_baseDelay; }
+        inline RetryPolicy& baseDelay(unsigned int baseDelay)
+        {
+            m_baseDelay = baseDelay;
+            return *this;
+        }
+
+        inline unsigned int maxDelay() const { return m_maxDelay; }
+        inline RetryPolicy& maxDelay(unsigned int maxDelay)
+        {
+            m_maxDelay = maxDelay;
+            return *this;
+        }
+
+        inline bool retryOnConnectErrors() const { return m_retryOnConnectErrors; }
+        inline RetryPolicy& retryOnConnectErrors(bool retryOnConnectErrors)
+        {
+            m_retryOnConnectErrors = retryOnConnectErrors;
+            return *this;
+        }
+
+        inline const TStatuses& retryStatuses() const { return m_retryStatuses; }
+        inline RetryPolicy& retryStatuses(const TStatuses& retryStatuses)
+        {
+            m_retryStatuses = retryStatuses;
+            return *this;
+        }
+
+        inline bool idempotentOnly() const { return m_idempotentOnly; }
+        inline RetryPolicy& idempotentOnly(bool idempotentOnly)
+        {
+            m_idempotentOnly = idempotentOnly;
+            return *this;
+        }
+
+        inline bool honourRetryAfter() const { return m_honourRetryAfter; }
+        inline RetryPolicy& honourRetryAfter(bool honourRetryAfter)
+        {
+            m_honourRetryAfter = honourRetryAfter;
+            return *this;
+        }
+
+        inline bool isRetryable(boost::beast::http::verb verb) const
+        {
+            return false == m_idempotentOnly || isIdempotent(verb);
+        }
+
+        inline bool isRetryable(unsigned int status) const
+        {
+            return std::find(m_retryStatuses.begin(), m_retryStatuses.end(), status) != m_retryStatuses.end();
+        }
+
+        // Exponential backoff with full jitter: uniform in [0, min(maxDelay, baseDelay * 2^attempt)]
+        inline std::chrono::milliseconds backoff(unsigned int attempt) const
+        {
+            static thread_local std::mt19937 generator{ std::random_device{}() };
+
+            auto ceiling = static_cast<double>(m_baseDelay) * std::pow(2.0, attempt);
+            auto upper = static_cast<unsigned int>(std::min(ceiling, static_cast<double>(m_maxDelay)));
+            std::uniform_int_distribution<unsigned int> distribution{ 0, upper };
+
+            return std::chrono::milliseconds(distribution(generator));
+        }
+
+        static inline bool isIdempotent(boost::beast::http::verb verb)
+        {
+            switch (verb)
+            {
+            case boost::beast::http::verb::get:
+            case boost::beast::http::verb::head:
+            case boost::beast::http::verb::put:
+            case boost::beast::http::verb::delete_:
+            case boost::beast::http::verb::options:
+            case boost::beast::http::verb::trace:
+                return true;
+            default:
+                return false;
+            }
+        }
+    };
+}
+
+#endif
@@ -2,14 +2,20 @@
 #define HTTP_TYPES_HPP_INCLUDED
 
 #include "Http/HttpAuth.hpp"
+#include "Http/HttpBinaryView.hpp"
 #include "Http/HttpBody.hpp"
+#include "Http/HttpCache.hpp"
+#include "Http/HttpChunkedUpload.hpp"
+#include "Http/HttpCircuitBreakerPolicy.hpp"
 #include "Http/HttpClient.hpp"
 #include "Http/HttpFormData.hpp"
 #include "Http/HttpForwards.hpp"
+#include "Http/HttpLazyJson.hpp"
 #include "Http/HttpMimeTypes.hpp"
 #include "Http/HttpOptions.hpp"
 #include "Http/HttpRequest.hpp"
 #include "Http/HttpResponse.hpp"
+#include "Http/HttpRetry.hpp"
 #include "Http/detail/HttpClientImpl.hpp"
 #include "Http/detail/HttpRequestImpl.hpp"
 
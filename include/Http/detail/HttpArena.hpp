@@ -0,0 +1,221 @@
+#ifndef HTTP_ARENA_HPP_INCLUDED
+#define HTTP_ARENA_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+
+namespace Http::detail
+{
+    // Free list of arena blocks shared by the sessions of a client
+    class ArenaPool
+    {
+    private:
+        using TMutex = std::mutex;
+        using TLock = std::lock_guard<TMutex>;
+
+        mutable TMutex m_mutex;
+        std::vector<void*> m_blocks;
+        std::size_t m_allocated;
+
+    public:
+        static constexpr std::size_t BlockSize = 8_KiB;
+        static constexpr std::size_t MaxFreeBlocks = 256;
+
+    public:
+        ArenaPool()
+            : m_mutex{}
+            , m_blocks{}
+            , m_allocated{ 0 }
+        {
+        }
+
+        virtual ~ArenaPool()
+        {
+            for (auto block : m_blocks) ::operator delete(block);
+        }
+
+        ArenaPool(const ArenaPool& other) = delete;
+        ArenaPool& operator=(const ArenaPool& other) = delete;
+        ArenaPool(ArenaPool&& other) = delete;
+        ArenaPool& operator=(ArenaPool&& other) = delete;
+
+        void* acquire()
+        {
+            {
+                TLock lock{ m_mutex };
+                if (false == m_blocks.empty())
+                {
+                    auto block = m_blocks.back();
+                    m_blocks.pop_back();
+                    return block;
+                }
+                ++m_allocated;
+            }
+
+            return ::operator new(BlockSize);
+        }
+
+        void release(void* block)
+        {
+            {
+                TLock lock{ m_mutex };
+                if (m_blocks.size() < MaxFreeBlocks) return m_blocks.push_back(block);
+                --m_allocated;
+            }
+
+            ::operator delete(block);
+        }
+
+        // Blocks currently obtained from the heap, either in use or free
+        std::size_t allocated() const
+        {
+            TLock lock{ m_mutex };
+            return m_allocated;
+        }
+    };
+
+    using TArenaPoolPtr = std::shared_ptr<ArenaPool>;
+
+    // Monotonic arena of a session: allocations are carved out of blocks that are all released at once.
+    // Not thread safe, a session allocating from a single strand at a time
+    class Arena
+    {
+    private:
+        struct Block
+        {
+            Block* next;
+        };
+
+        static constexpr std::size_t HeaderSize = alignof(std::max_align_t);
+
+        TArenaPoolPtr m_pool;
+        Block* m_blocks;
+        Block* m_large;
+        std::byte* m_cursor;
+        std::size_t m_remaining;
+
+    public:
+        explicit Arena(TArenaPoolPtr pool = nullptr)
+            : m_pool{ pool }
+            , m_blocks{ nullptr }
+            , m_large{ nullptr }
+            , m_cursor{ nullptr }
+            , m_remaining{ 0 }
+        {
+        }
+
+        virtual ~Arena()
+        {
+            while (nullptr != m_blocks)
+            {
+                auto next = m_blocks->next;
+                if (nullptr != m_pool) m_pool->release(m_blocks);
+                else ::operator delete(m_blocks);
+                m_blocks = next;
+            }
+
+            while (nullptr != m_large)
+            {
+                auto next = m_large->next;
+                ::operator delete(m_large);
+                m_large = next;
+            }
+        }
+
+        Arena(const Arena& other) = delete;
+        Arena& operator=(const Arena& other) = delete;
+        Arena(Arena&& other) = delete;
+        Arena& operator=(Arena&& other) = delete;
+
+        void* allocate(std::size_t size, std::size_t alignment)
+        {
+            // Allocations that don't fit a block get their own
+            if (size + alignment > ArenaPool::BlockSize - HeaderSize)
+            {
+                auto large = static_cast<Block*>(::operator new(HeaderSize + size));
+                large->next = m_large;
+                m_large = large;
+                return reinterpret_cast<std::byte*>(large) + HeaderSize;
+            }
+
+            void* cursor = m_cursor;
+            if (nullptr == std::align(alignment, size, cursor, m_remaining))
+            {
+                auto block = static_cast<Block*>(nullptr != m_pool ? m_pool->acquire() : ::operator new(ArenaPool::BlockSize));
+                block->next = m_blocks;
+                m_blocks = block;
+                cursor = reinterpret_cast<std::byte*>(block) + HeaderSize;
+                m_remaining = ArenaPool::BlockSize - HeaderSize;
+                std::align(alignment, size, cursor, m_remaining);
+            }
+
+            m_cursor = static_cast<std::byte*>(cursor) + size;
+            m_remaining -= size;
+            return cursor;
+        }
+    };
+
+    using TArenaPtr = std::shared_ptr<Arena>;
+
+    // Allocator of the per request beast objects. It keeps the arena alive as long as they are, and
+    // falls back to the heap when default constructed
+    template <typename T>
+    class ArenaAllocator
+    {
+    private:
+        template <typename U>
+        friend class ArenaAllocator;
+
+        TArenaPtr m_arena;
+
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+    public:
+        ArenaAllocator() noexcept = default;
+
+        explicit ArenaAllocator(TArenaPtr arena) noexcept
+            : m_arena{ std::move(arena) }
+        {
+        }
+
+        template <typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+            : m_arena{ other.m_arena }
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            if (nullptr == m_arena) return static_cast<T*>(::operator new(n * sizeof(T)));
+            return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept
+        {
+            if (nullptr == m_arena) ::operator delete(p);
+        }
+
+        template <typename U>
+        bool operator==(const ArenaAllocator<U>& other) const noexcept
+        {
+            return m_arena == other.m_arena;
+        }
+
+        template <typename U>
+        bool operator!=(const ArenaAllocator<U>& other) const noexcept
+        {
+            return m_arena != other.m_arena;
+        }
+    };
+
+    template <typename T, typename... Args>
+    std::shared_ptr<T> allocateShared(const TFieldsAllocator& allocator, Args&&... args)
+    {
+        return std::allocate_shared<T>(ArenaAllocator<T>{ allocator }, std::forward<Args>(args)...);
+    }
+}
+
+#endif
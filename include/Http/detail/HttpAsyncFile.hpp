@@ -0,0 +1,275 @@
+#ifndef HTTP_ASYNC_FILE_HPP_INCLUDED
+#define HTTP_ASYNC_FILE_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+
+#if defined(HTTP_ENABLE_IO_URING)
+
+#if !defined(BOOST_ASIO_HAS_FILE)
+#error "HTTP_ENABLE_IO_URING requires BOOST_ASIO_HAS_IO_URING and liburing"
+#endif
+
+#include <unistd.h>
+
+namespace Http::detail
+{
+    // Dedicated io_context running the io_uring file operations, off the network threads
+    class FileRing
+    {
+    private:
+        boost::asio::io_context m_context;
+        boost::asio::executor_work_guard<boost::asio::io_context::executor_type> m_guard;
+        std::thread m_thread;
+
+    public:
+        FileRing()
+            : m_context{ 1 }
+            , m_guard{ boost::asio::make_work_guard(m_context) }
+            , m_thread{ [this]() { m_context.run(); } }
+        {
+        }
+
+        virtual ~FileRing()
+        {
+            m_guard.reset();
+            m_context.stop();
+            if (m_thread.joinable()) m_thread.join();
+        }
+
+        FileRing(const FileRing& other) = delete;
+        FileRing& operator=(const FileRing& other) = delete;
+        FileRing(FileRing&& other) = delete;
+        FileRing& operator=(FileRing&& other) = delete;
+
+        static FileRing& instance()
+        {
+            static FileRing ring;
+            return ring;
+        }
+
+        boost::asio::io_context::executor_type executor()
+        {
+            return m_context.get_executor();
+        }
+    };
+
+    // File with the boost::beast::file interface whose reads are prefetched one buffer ahead
+    // and whose writes complete behind the caller, so that disk latency overlaps network I/O
+    class AsyncFile
+    {
+    private:
+        using TFile = boost::asio::random_access_file;
+        using TResult = std::pair<boost::system::error_code, std::size_t>;
+
+        std::unique_ptr<TFile> m_file;
+        std::uint64_t m_offset;
+        std::vector<char> m_pending;
+        std::uint64_t m_pendingOffset;
+        std::future<TResult> m_inflight;
+
+    public:
+        AsyncFile()
+            : m_file{}
+            , m_offset{ 0 }
+            , m_pending{}
+            , m_pendingOffset{ 0 }
+            , m_inflight{}
+        {
+        }
+
+        virtual ~AsyncFile()
+        {
+            close();
+        }
+
+        AsyncFile(const AsyncFile& other) = delete;
+        AsyncFile& operator=(const AsyncFile& other) = delete;
+        AsyncFile(AsyncFile&& other) = default;
+        AsyncFile& operator=(AsyncFile&& other) = default;
+
+        bool is_open() const
+        {
+            return nullptr != m_file && m_file->is_open();
+        }
+
+        void open(char const* path, boost::beast::file_mode mode, boost::beast::error_code& ec)
+        {
+            close();
+
+            m_file = std::make_unique<TFile>(FileRing::instance().executor());
+            m_file->open(path, flags(mode), ec);
+            if (ec) return m_file.reset();
+
+            opened(mode, ec);
+        }
+
+        // Shares a file already open through a duplicate of its descriptor, so that it isn't opened twice
+        void open(int handle, boost::beast::file_mode mode, boost::beast::error_code& ec)
+        {
+            close();
+
+            auto duplicate = ::dup(handle);
+            if (-1 == duplicate)
+            {
+                ec = { errno, boost::system::system_category() };
+                return;
+            }
+
+            m_file = std::make_unique<TFile>(FileRing::instance().executor());
+            m_file->assign(duplicate, ec);
+            if (ec)
+            {
+                ::close(duplicate);
+                return m_file.reset();
+            }
+
+            opened(mode, ec);
+        }
+
+        void close(boost::beast::error_code& ec)
+        {
+            ec = {};
+            if (nullptr == m_file) return;
+
+            wait(ec);
+            boost::beast::error_code closeError;
+            m_file->close(closeError);
+            if (!ec) ec = closeError;
+            m_file.reset();
+        }
+
+        void close()
+        {
+            boost::beast::error_code ignored;
+            close(ignored);
+        }
+
+        std::uint64_t size(boost::beast::error_code& ec) const
+        {
+            ec = {};
+            return nullptr == m_file ? 0 : m_file->size(ec);
+        }
+
+        std::uint64_t pos(boost::beast::error_code& ec) const
+        {
+            ec = {};
+            return m_offset;
+        }
+
+        void seek(std::uint64_t offset, boost::beast::error_code& ec)
+        {
+            ec = {};
+            m_offset = offset;
+        }
+
+        std::size_t read(void* buffer, std::size_t n, boost::beast::error_code& ec)
+        {
+            ec = {};
+            if (0 == n) return 0;
+
+            // A prefetch made at another offset (after a seek) or of another size is dropped
+            if (false == m_inflight.valid() || m_pendingOffset != m_offset || m_pending.size() != n)
+            {
+                wait(ec);
+                if (ec) return 0;
+                prefetch(m_offset, n);
+            }
+
+            auto result = m_inflight.get();
+            if (result.first && boost::asio::error::eof != result.first)
+            {
+                ec = result.first;
+                return 0;
+            }
+
+            std::memcpy(buffer, m_pending.data(), result.second);
+            m_offset += result.second;
+
+            if (0 != result.second) prefetch(m_offset, n);
+
+            return result.second;
+        }
+
+        std::size_t write(void const* buffer, std::size_t n, boost::beast::error_code& ec)
+        {
+            // The previous write must be done before its buffer is reused, which also reports its error
+            wait(ec);
+            if (ec) return 0;
+
+            m_pending.assign(static_cast<const char*>(buffer), static_cast<const char*>(buffer) + n);
+            m_pendingOffset = m_offset;
+            m_offset += n;
+
+            auto prom = std::make_shared<std::promise<TResult>>();
+            m_inflight = prom->get_future();
+            boost::asio::async_write_at(*m_file, m_pendingOffset, boost::asio::buffer(m_pending), [prom](const boost::system::error_code& ec, std::size_t n)
+            {
+                prom->set_value({ ec, n });
+            });
+
+            return n;
+        }
+
+        // Waits for the write still in flight
+        void flush(boost::beast::error_code& ec)
+        {
+            wait(ec);
+        }
+
+    private:
+        void opened(boost::beast::file_mode mode, boost::beast::error_code& ec)
+        {
+            // Positional writes need the end of the file to append to it
+            m_offset = 0;
+            if (boost::beast::file_mode::append == mode || boost::beast::file_mode::append_existing == mode) m_offset = m_file->size(ec);
+        }
+
+        static boost::asio::file_base::flags flags(boost::beast::file_mode mode)
+        {
+            switch (mode)
+            {
+            case boost::beast::file_mode::read:
+            case boost::beast::file_mode::scan:
+                return boost::asio::file_base::read_only;
+            case boost::beast::file_mode::write:
+                return boost::asio::file_base::write_only | boost::asio::file_base::create | boost::asio::file_base::truncate;
+            case boost::beast::file_mode::write_new:
+                return boost::asio::file_base::write_only | boost::asio::file_base::create | boost::asio::file_base::exclusive;
+            case boost::beast::file_mode::write_existing:
+                return boost::asio::file_base::write_only;
+            case boost::beast::file_mode::append:
+                return boost::asio::file_base::write_only | boost::asio::file_base::create;
+            case boost::beast::file_mode::append_existing:
+            default:
+                return boost::asio::file_base::write_only;
+            }
+        }
+
+        void prefetch(std::uint64_t offset, std::size_t n)
+        {
+            m_pending.resize(n);
+            m_pendingOffset = offset;
+
+            auto prom = std::make_shared<std::promise<TResult>>();
+            m_inflight = prom->get_future();
+            m_file->async_read_some_at(offset, boost::asio::buffer(m_pending), [prom](const boost::system::error_code& ec, std::size_t n)
+            {
+                prom->set_value({ ec, n });
+            });
+        }
+
+        void wait(boost::beast::error_code& ec)
+        {
+            ec = {};
+            if (false == m_inflight.valid()) return;
+
+            auto result = m_inflight.get();
+            m_pendingOffset = std::numeric_limits<std::uint64_t>::max();
+            if (result.first && boost::asio::error::eof != result.first) ec = result.first;
+        }
+    };
+}
+
+#endif
+
+#endif
@@ -0,0 +1,244 @@
+#ifndef HTTP_BUFFER_POOL_HPP_INCLUDED
+#define HTTP_BUFFER_POOL_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+
+namespace Http::detail
+{
+    // Size classed buffers recycled between sessions and body writers. Each thread keeps a few
+    // buffers per class at hand and exchanges the rest with a shared free list
+    class BufferPool
+    {
+    private:
+        using TMutex = std::mutex;
+        using TLock = std::lock_guard<TMutex>;
+        using TFreeList = std::vector<void*>;
+
+    public:
+        static constexpr std::size_t MinClassSize = 4_KiB;
+        static constexpr std::size_t ClassCount = 11;
+        static constexpr std::size_t MaxClassSize = MinClassSize << (ClassCount - 1);
+        static constexpr std::size_t ThreadCacheSize = 4;
+        static constexpr std::size_t MaxFreeBuffers = 64;
+
+    private:
+        struct ThreadCache
+        {
+            std::array<TFreeList, ClassCount> m_free;
+
+            ~ThreadCache()
+            {
+                for (std::size_t index = 0; index < ClassCount; ++index)
+                {
+                    for (auto buffer : m_free[index]) BufferPool::instance().releaseShared(buffer, index);
+                }
+            }
+        };
+
+        mutable TMutex m_mutex;
+        std::array<TFreeList, ClassCount> m_free;
+        std::atomic<std::size_t> m_allocated;
+
+    public:
+        BufferPool()
+            : m_mutex{}
+            , m_free{}
+            , m_allocated{ 0 }
+        {
+        }
+
+        virtual ~BufferPool()
+        {
+            for (auto& free : m_free)
+            {
+                for (auto buffer : free) ::operator delete(buffer);
+            }
+        }
+
+        BufferPool(const BufferPool& other) = delete;
+        BufferPool& operator=(const BufferPool& other) = delete;
+        BufferPool(BufferPool&& other) = delete;
+        BufferPool& operator=(BufferPool&& other) = delete;
+
+        static BufferPool& instance()
+        {
+            static BufferPool pool;
+            return pool;
+        }
+
+        // Size actually reserved for a request of the given size
+        static std::size_t capacity(std::size_t size)
+        {
+            if (size > MaxClassSize) return size;
+            return MinClassSize << classIndex(size);
+        }
+
+        void* acquire(std::size_t size)
+        {
+            if (size > MaxClassSize) return ::operator new(size);
+
+            auto index = classIndex(size);
+            auto& cached = cache().m_free[index];
+            if (false == cached.empty())
+            {
+                auto buffer = cached.back();
+                cached.pop_back();
+                return buffer;
+            }
+
+            {
+                TLock lock{ m_mutex };
+                if (false == m_free[index].empty())
+                {
+                    auto buffer = m_free[index].back();
+                    m_free[index].pop_back();
+                    return buffer;
+                }
+            }
+
+            ++m_allocated;
+            return ::operator new(MinClassSize << index);
+        }
+
+        void release(void* buffer, std::size_t size)
+        {
+            if (nullptr == buffer) return;
+            if (size > MaxClassSize) return ::operator delete(buffer);
+
+            auto index = classIndex(size);
+            auto& cached = cache().m_free[index];
+            if (cached.size() < ThreadCacheSize) return cached.push_back(buffer);
+
+            releaseShared(buffer, index);
+        }
+
+        // Pooled buffers obtained from the heap so far
+        std::size_t allocated() const
+        {
+            return m_allocated;
+        }
+
+    private:
+        static std::size_t classIndex(std::size_t size)
+        {
+            std::size_t index = 0;
+            while ((MinClassSize << index) < size) ++index;
+            return index;
+        }
+
+        static ThreadCache& cache()
+        {
+            static thread_local ThreadCache cache;
+            return cache;
+        }
+
+        void releaseShared(void* buffer, std::size_t index)
+        {
+            {
+                TLock lock{ m_mutex };
+                if (m_free[index].size() < MaxFreeBuffers) return m_free[index].push_back(buffer);
+            }
+
+            --m_allocated;
+            ::operator delete(buffer);
+        }
+    };
+
+    // Allocator drawing from the buffer pool, for the session read buffer
+    template <typename T>
+    class PooledAllocator
+    {
+    public:
+        using value_type = T;
+
+    public:
+        PooledAllocator() noexcept = default;
+
+        template <typename U>
+        PooledAllocator(const PooledAllocator<U>&) noexcept
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            return static_cast<T*>(BufferPool::instance().acquire(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept
+        {
+            BufferPool::instance().release(p, n * sizeof(T));
+        }
+
+        template <typename U>
+        bool operator==(const PooledAllocator<U>&) const noexcept
+        {
+            return true;
+        }
+
+        template <typename U>
+        bool operator!=(const PooledAllocator<U>&) const noexcept
+        {
+            return false;
+        }
+    };
+
+    using TFlatBuffer = boost::beast::basic_flat_buffer<PooledAllocator<char>>;
+
+    // Buffer borrowed from the pool by a body writer, given back when the writer is done with it
+    class PooledBuffer
+    {
+    private:
+        char* m_data;
+        std::size_t m_size;
+
+    public:
+        PooledBuffer()
+            : m_data{ nullptr }
+            , m_size{ 0 }
+        {
+        }
+
+        explicit PooledBuffer(std::size_t size)
+            : m_data{ static_cast<char*>(BufferPool::instance().acquire(size)) }
+            , m_size{ size }
+        {
+        }
+
+        virtual ~PooledBuffer()
+        {
+            reset();
+        }
+
+        PooledBuffer(const PooledBuffer& other) = delete;
+        PooledBuffer& operator=(const PooledBuffer& other) = delete;
+
+        PooledBuffer(PooledBuffer&& other) noexcept
+            : m_data{ std::exchange(other.m_data, nullptr) }
+            , m_size{ std::exchange(other.m_size, 0) }
+        {
+        }
+
+        PooledBuffer& operator=(PooledBuffer&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                m_data = std::exchange(other.m_data, nullptr);
+                m_size = std::exchange(other.m_size, 0);
+            }
+            return *this;
+        }
+
+        char* data() const { return m_data; }
+        std::size_t size() const { return m_size; }
+
+        void reset()
+        {
+            BufferPool::instance().release(m_data, m_size);
+            m_data = nullptr;
+            m_size = 0;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef HTTP_CIRCUIT_BREAKER_HPP_INCLUDED
+#define HTTP_CIRCUIT_BREAKER_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+#include "Http/HttpCircuitBreakerPolicy.hpp"
+
+namespace Http::detail
+{
+    // Closed / open / half-open breaker over a sliding window of call outcomes
+    class CircuitBreaker
+    {
+    public:
+        enum class State
+        {
+            Closed,
+            Open,
+            HalfOpen
+        };
+
+    private:
+        using TMutex = std::mutex;
+        using TLock = std::lock_guard<TMutex>;
+        using TClock = std::chrono::steady_clock;
+
+        struct Outcome
+        {
+            bool failure = false;
+            bool slow = false;
+        };
+
+        TMutex m_mutex;
+        CircuitBreakerPolicy m_policy;
+        State m_state;
+        std::vector<Outcome> m_window;
+        std::size_t m_next;
+        TClock::time_point m_openUntil;
+        unsigned int m_probes;
+        unsigned int m_probeSuccesses;
+
+    public:
+        CircuitBreaker(const CircuitBreakerPolicy& policy)
+            : m_mutex{}
+            , m_policy{ policy }
+            , m_state{ State::Closed }
+            , m_window{}
+            , m_next{ 0 }
+            , m_openUntil{}
+            , m_probes{ 0 }
+            , m_probeSuccesses{ 0 }
+        {
+            m_window.reserve(m_policy.windowSize());
+        }
+
+        virtual ~CircuitBreaker() = default;
+        CircuitBreaker(const CircuitBreaker& other) = delete;
+        CircuitBreaker& operator=(const CircuitBreaker& other) = delete;
+        CircuitBreaker(CircuitBreaker&& other) = delete;
+        CircuitBreaker& operator=(CircuitBreaker&& other) = delete;
+
+        State state()
+        {
+            TLock lock{ m_mutex };
+            return m_state;
+        }
+
+        // Returns false when the call must fail fast
+        bool tryAcquire()
+        {
+            TLock lock{ m_mutex };
+
+            if (State::Open == m_state)
+            {
+                if (TClock::now() < m_openUntil) return false;
+                m_state = State::HalfOpen;
+                m_probes = 0;
+                m_probeSuccesses = 0;
+            }
+
+            if (State::HalfOpen == m_state)
+            {
+                if (m_probes >= m_policy.halfOpenProbes()) return false;
+                ++m_probes;
+            }
+
+            return true;
+        }
+
+        // Gives back the probe taken by a call that ended without telling anything about the host
+        void abandon()
+        {
+            TLock lock{ m_mutex };
+            if (State::HalfOpen == m_state && m_probes > m_probeSuccesses) --m_probes;
+        }
+
+        void record(bool success, std::chrono::milliseconds latency)
+        {
+            TLock lock{ m_mutex };
+
+            Outcome outcome{ false == success, latency >= std::chrono::milliseconds(m_policy.slowCallThreshold()) };
+
+            switch (m_state)
+            {
+            case State::Closed:
+            {
+                if (m_window.size() < m_policy.windowSize())
+                {
+                    m_window.push_back(outcome);
+                }
+                else if (false == m_window.empty())
+                {
+                    m_window[m_next] = outcome;
+                    m_next = (m_next + 1) % m_window.size();
+                }
+
+                if (m_window.size() < std::max(1u, m_policy.minCalls())) break;
+
+                auto nbFailures = std::count_if(m_window.begin(), m_window.end(), [](const Outcome& o) { return o.failure; });
+                auto nbSlow = std::count_if(m_window.begin(), m_window.end(), [](const Outcome& o) { return o.slow; });
+                auto size = static_cast<double>(m_window.size());
+
+                if (nbFailures / size >= m_policy.failureRatio() || nbSlow / size >= m_policy.slowCallRatio()) open();
+                break;
+            }
+            case State::HalfOpen:
+            {
+                if (outcome.failure || outcome.slow) open();
+                else if (++m_probeSuccesses >= m_policy.halfOpenProbes()) close();
+                break;
+            }
+            case State::Open:
+                break;
+            }
+        }
+
+    private:
+        void open()
+        {
+            m_state = State::Open;
+            m_openUntil = TClock::now() + std::chrono::milliseconds(m_policy.openDuration());
+        }
+
+        void close()
+        {
+            m_state = State::Closed;
+            m_window.clear();
+            m_next = 0;
+        }
+    };
+}
+
+#endif
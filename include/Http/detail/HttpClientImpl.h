@@ -5,11 +5,20 @@
 #include "Http/HttpOptions.hpp"
 #include "Http/HttpRequest.hpp"
 #include "Http/HttpResponse.hpp"
+#include "Http/HttpChunkedUpload.hpp"
+#include "Http/detail/HttpISession.hpp"
+#include "Http/detail/HttpRetryBudget.hpp"
+#include "Http/detail/HttpLatencyTracker.hpp"
+#include "Http/detail/HttpEndpointPool.hpp"
+#include "Http/detail/HttpCircuitBreaker.hpp"
+#include "Http/detail/HttpRateLimiter.hpp"
+#include "Http/detail/HttpTokenBucket.hpp"
+#include "Http/detail/HttpResponseCache.hpp"
+#include "Http/detail/HttpDiskCache.hpp"
+#include "Http/detail/HttpArena.hpp"
 
 namespace Http::detail
 {
-    struct ISession;
-
     struct ClientImpl : public std::enable_shared_from_this<ClientImpl>
     {
     private:
@@ -21,11 +30,16 @@ namespace Http::detail
         using TWorkguard = boost::asio::executor_work_guard<boost::asio::io_context::executor_type>;
         using TSessionPtr = std::shared_ptr<ISession>;
         using TSessionPtrs = std::map<boost::uuids::uuid, TSessionPtr>;
+        using TCircuitBreakers = std::vector<std::unique_ptr<CircuitBreaker>>;
+        using TTokenBucketPtr = std::unique_ptr<TokenBucket>;
+
+        struct Follower
+        {
+            TRequestImplPtr req;
+            TResponseHandler handler;
+        };
 
-        static constexpr char const * const DefaultPlainPort = "80";
-        static constexpr char const * const DefaultSslPort = "443";
-        static constexpr char const * const Https = "https";
-        static constexpr char const * const HostPortScheme = R"(^(?:(http|https):\/\/)?([a-z0-9\-\.]+)(?::(\d+))?$)";
+        using TFlights = std::map<std::string, std::vector<Follower>>;
 
         mutable boost::asio::io_context m_ioc;
 
@@ -33,16 +47,25 @@ namespace Http::detail
         TThreads m_threads;
         mutable TMutex m_mutex;
 
-        std::string m_url;
-        std::string m_host;
-        std::string m_port;
-        bool m_isSsl;
         Options m_options;
+        mutable EndpointPool m_endpoints;
         mutable TSessionPtrs m_sessions;
+        TCircuitBreakers m_breakers;
+        mutable RetryBudget m_retryBudget;
+        mutable LatencyTracker m_headerLatency;
+        mutable RateLimiter m_rateLimiter;
+        TTokenBucketPtr m_uploadPacer;
+        TTokenBucketPtr m_downloadPacer;
+        std::unique_ptr<ResponseCache> m_cache;
+        std::unique_ptr<DiskCache> m_diskCache;
+        mutable TMutex m_flightsMutex;
+        mutable TFlights m_flights;
+        mutable std::map<std::string, bool> m_preferIpv6;
+        TArenaPoolPtr m_arenaPool;
 
     public:
         ClientImpl() = delete;
-        ClientImpl(const std::string &url, Options options);
+        ClientImpl(const std::vector<std::string>& urls, Options options);
         virtual ~ClientImpl();
         ClientImpl(const ClientImpl& other) = delete;
         ClientImpl &operator=(const ClientImpl& other) = delete;
@@ -61,12 +84,41 @@ namespace Http::detail
         Request patch(const std::stringstream& target) const;
         Request delete_(const std::stringstream& target) const;
 
-        void cancel(const boost::uuids::uuid& id) const;
+        void cancel(const RequestImpl* req) const;
         void cancelAll() const;
         void shutdown();
         void clearSession(const boost::uuids::uuid& id) const;
+        void release(std::size_t endpoint, std::optional<bool> success, std::chrono::milliseconds latency) const;
+        std::optional<bool> preferIpv6(const std::string& host) const;
+        void preferIpv6(const std::string& host, bool preferIpv6) const;
 
         std::shared_future<Response> send(TRequestImplPtr req) const;
+        void submit(TRequestImplPtr req, TResponseHandler handler) const;
+        std::shared_future<Response> upload(const std::string& target, const fs::path& path, const ChunkedUpload& upload) const;
+        TSessionPtr dispatch(TRequestImplPtr req, TResponseHandler handler, const Options& options, unsigned int attempt, TDispatchHook hook = {}) const;
+        void hedge(TRequestImplPtr req, TResponseHandler handler, const Options& options) const;
+        void start(TRequestImplPtr req, TResponseHandler handler, const Options& options) const;
+        bool fromCache(TRequestImplPtr req, TResponseHandler& handler, Options& options) const;
+        bool joinFlight(TRequestImplPtr req, TResponseHandler& handler, const Options& options) const;
+        void resume(TRequestImplPtr req, TResponseHandler handler, const Options& options) const;
+        void download(TRequestImplPtr req, TResponseHandler handler, const Options& options) const;
+
+        RetryBudget& retryBudget() const { return m_retryBudget; }
+        LatencyTracker& headerLatency() const { return m_headerLatency; }
+        RateLimiter& rateLimiter() const { return m_rateLimiter; }
+        TokenBucket* uploadPacer() const { return m_uploadPacer.get(); }
+        TokenBucket* downloadPacer() const { return m_downloadPacer.get(); }
+        const TArenaPoolPtr& arenaPool() const { return m_arenaPool; }
+        CacheStats cacheStats() const;
+        CircuitBreaker* circuitBreaker(std::size_t endpoint) const { return m_breakers.empty() ? nullptr : m_breakers[endpoint].get(); }
+
+    private:
+        static std::vector<Endpoint> endpoints(const std::vector<std::string>& urls, const Options& options);
+        static std::optional<std::uint64_t> rangeTotal(const Response& response);
+        TResponseHandler leadFlight(const std::string& key, TResponseHandler handler) const;
+        void cancelFollowers(const RequestImpl* req) const;
+        static Response whole(const Response& response);
+        static fs::path rangesMarker(const fs::path& path);
     };
 }
 
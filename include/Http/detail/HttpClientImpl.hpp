@@ -8,35 +8,41 @@
 
 namespace Http::detail
 {
-    ClientImpl::ClientImpl(const std::string &url, Options options)
+    ClientImpl::ClientImpl(const std::vector<std::string>& urls, Options options)
         : m_ioc{}
         , m_workguard{ m_ioc.get_executor() }
         , m_threads{}
         , m_mutex{}
-        , m_url{ boost::algorithm::to_lower_copy(url) }
-        , m_host{}
-        , m_port{ DefaultPlainPort }
-        , m_isSsl{ false }
         , m_options{ options }
+        , m_endpoints{ endpoints(urls, options), options }
         , m_sessions{}
+        , m_breakers{}
+        , m_retryBudget{ options.retryBudget().value_or(RetryBudget::DefaultRatio) }
+        , m_headerLatency{}
+        , m_rateLimiter{ options }
+        , m_uploadPacer{ TokenBucket::pacer(options.maxTotalUploadRate()) }
+        , m_downloadPacer{ TokenBucket::pacer(options.maxTotalDownloadRate()) }
+        , m_cache{ options.cacheSize().has_value() ? std::make_unique<ResponseCache>(options.cacheSize().value()) : nullptr }
+        , m_diskCache{ options.cacheDir().has_value() ? std::make_unique<DiskCache>(options.cacheDir().value(), options.cacheDirSize().value_or(Options::DefaultCacheDirSize)) : nullptr }
+        , m_flightsMutex{}
+        , m_flights{}
+        , m_preferIpv6{}
+        , m_arenaPool{ std::make_shared<ArenaPool>() }
     {
+        if (m_options.circuitBreaker().has_value())
+        {
+            for (std::size_t i = 0; i < m_endpoints.size(); ++i)
+            {
+                m_breakers.push_back(std::make_unique<CircuitBreaker>(m_options.circuitBreaker().value()));
+            }
+        }
+
         auto nbThreads = m_options.nbThreads().value_or(Options::DefaultNbThreads);
         m_threads.reserve(nbThreads);
         for (auto i = 0u; i < nbThreads; ++i)
         {
             m_threads.emplace_back([this] { m_ioc.run(); });
         }
-
-        std::regex schemeHostPort{ HostPortScheme, std::regex_constants::ECMAScript | std::regex_constants::icase };
-
-        std::smatch match;
-        if (true == std::regex_match(url, match, schemeHostPort))
-        {
-            if (Https == match[1].str()) m_isSsl = true;
-            m_host = match[2].str();
-            m_port = m_isSsl ? DefaultSslPort : DefaultPlainPort;
-            if (!match[3].str().empty()) m_port = match[3].str();
-        }
     }
 
     ClientImpl::~ClientImpl()
@@ -46,27 +52,27 @@ namespace Http::detail
 
     inline Request ClientImpl::get(const std::string& target) const
     {
-        return Request{ m_host, m_port, boost::beast::http::verb::get, target, shared_from_this() };
+        return Request{ boost::beast::http::verb::get, target, shared_from_this() };
     }
 
     inline Request ClientImpl::post(const std::string& target) const
     {
-        return Request{ m_host, m_port, boost::beast::http::verb::post, target, shared_from_this() };
+        return Request{ boost::beast::http::verb::post, target, shared_from_this() };
     }
 
     inline Request ClientImpl::put(const std::string& target) const
     {
-        return Request{ m_host, m_port, boost::beast::http::verb::put, target, shared_from_this() };
+        return Request{ boost::beast::http::verb::put, target, shared_from_this() };
     }
 
     inline Request ClientImpl::patch(const std::string& target) const
     {
-        return Request{ m_host, m_port, boost::beast::http::verb::patch, target, shared_from_this() };
+        return Request{ boost::beast::http::verb::patch, target, shared_from_this() };
     }
 
     inline Request ClientImpl::delete_(const std::string& target) const
     {
-        return Request{ m_host, m_port, boost::beast::http::verb::delete_, target, shared_from_this() };
+        return Request{ boost::beast::http::verb::delete_, target, shared_from_this() };
     }
 
     inline Request ClientImpl::get(const std::stringstream& target) const
@@ -94,15 +100,21 @@ namespace Http::detail
         return delete_(target.str());
     }
 
-    inline void ClientImpl::cancel(const boost::uuids::uuid& id) const
+    inline void ClientImpl::cancel(const RequestImpl* req) const
     {
+        cancelFollowers(req);
+
         TLock lock{ m_mutex };
-        auto it = m_sessions.find(id);
-        if (it != m_sessions.end()) it->second->cancel();
+        for (auto&[id, session] : m_sessions)
+        {
+            if (session->request()->m_origin == req) session->cancel();
+        }
     }
 
     inline void ClientImpl::cancelAll() const
     {
+        cancelFollowers(nullptr);
+
         TLock lock{ m_mutex };
         for (auto&[id, session] : m_sessions)
         {
@@ -110,6 +122,27 @@ namespace Http::detail
         }
     }
 
+    // Answers the followers of the request, or all of them, before their leader could hand its flight over
+    inline void ClientImpl::cancelFollowers(const RequestImpl* req) const
+    {
+        std::vector<Follower> canceled;
+        {
+            TLock lock{ m_flightsMutex };
+            for (auto& [key, followers] : m_flights)
+            {
+                auto it = std::stable_partition(followers.begin(), followers.end(), [req](const auto& follower) {
+                    return nullptr != req && follower.req.get() != req;
+                });
+                std::move(it, followers.end(), std::back_inserter(canceled));
+                followers.erase(it, followers.end());
+            }
+        }
+
+        Response response;
+        response.handleCancel();
+        for (auto& follower : canceled) follower.handler(response);
+    }
+
     inline void ClientImpl::shutdown()
     {
         m_ioc.stop();
@@ -123,36 +156,743 @@ namespace Http::detail
         m_sessions.erase(id);
     }
 
+    // Calls without an outcome (canceled, rate limited) only free their endpoint
+    inline void ClientImpl::release(std::size_t endpoint, std::optional<bool> success, std::chrono::milliseconds latency) const
+    {
+        auto breaker = circuitBreaker(endpoint);
+        if (false == success.has_value())
+        {
+            m_endpoints.release(endpoint);
+            if (nullptr != breaker) breaker->abandon();
+            return;
+        }
+
+        m_endpoints.release(endpoint, success.value());
+        if (nullptr != breaker) breaker->record(success.value(), latency);
+    }
+
+    inline std::optional<bool> ClientImpl::preferIpv6(const std::string& host) const
+    {
+        TLock lock{ m_mutex };
+        auto it = m_preferIpv6.find(host);
+        if (it == m_preferIpv6.end()) return std::nullopt;
+        return it->second;
+    }
+
+    inline void ClientImpl::preferIpv6(const std::string& host, bool preferIpv6) const
+    {
+        TLock lock{ m_mutex };
+        m_preferIpv6[host] = preferIpv6;
+    }
+
+    inline std::vector<Endpoint> ClientImpl::endpoints(const std::vector<std::string>& urls, const Options& options)
+    {
+        std::vector<Endpoint> endpoints;
+
+        for (const auto& url : urls)
+        {
+            auto endpoint = Endpoint::parse(url);
+
+            if (true == options.resolveAll().value_or(false))
+            {
+                boost::asio::io_context ioc;
+                boost::asio::ip::tcp::resolver resolver{ ioc };
+                boost::beast::error_code ec;
+                auto results = resolver.resolve(endpoint.host, endpoint.port, ec);
+
+                std::size_t nbResolved = 0;
+                for (const auto& result : results)
+                {
+                    auto resolved = endpoint;
+                    resolved.address = result.endpoint().address().to_string();
+                    auto found = std::find_if(endpoints.begin(), endpoints.end(), [&resolved](const Endpoint& other) {
+                        return other.address == resolved.address && other.port == resolved.port;
+                    });
+                    if (found == endpoints.end()) endpoints.push_back(resolved);
+                    ++nbResolved;
+                }
+
+                if (0 != nbResolved) continue;
+            }
+
+            endpoints.push_back(endpoint);
+        }
+
+        return endpoints;
+    }
+
     inline std::shared_future<Response> ClientImpl::send(TRequestImplPtr req) const
     {
-        std::promise<Response> prom;
-        auto res = prom.get_future();
+        auto prom = std::make_shared<std::promise<Response>>();
+        std::shared_future<Response> res = prom->get_future();
+
+        submit(req, [prom](const Response& response) { prom->set_value(response); });
+
+        return res;
+    }
+
+    inline void ClientImpl::submit(TRequestImplPtr req, TResponseHandler handler) const
+    {
+        m_retryBudget.deposit();
 
         auto options = m_options + req->options();
 
+        if (true == fromCache(req, handler, options)) return;
+        if (true == joinFlight(req, handler, options)) return;
+
+        if (false == m_rateLimiter.enabled())
+        {
+            start(req, handler, options);
+            return;
+        }
+
+        auto delay = m_rateLimiter.admit();
+        if (false == delay.has_value())
+        {
+            Response response;
+            response.handleRateLimited();
+            handler(response);
+        }
+        else if (std::chrono::nanoseconds::zero() == delay.value())
+        {
+            start(req, handler, options);
+        }
+        else
+        {
+            auto timer = std::make_shared<boost::asio::steady_timer>(boost::asio::make_strand(m_ioc), delay.value());
+            timer->async_wait([weak = weak_from_this(), timer, req, handler, options](const boost::beast::error_code&)
+            {
+                auto self = weak.lock();
+                if (nullptr == self) return;
+
+                self->m_rateLimiter.dequeue();
+                self->start(req, handler, options);
+            });
+        }
+    }
+
+    // Sends the chunks of a file with bounded parallelism, retrying each failed chunk
+    inline std::shared_future<Response> ClientImpl::upload(const std::string& target, const fs::path& path, const ChunkedUpload& upload) const
+    {
+        struct Upload
+        {
+            TMutex m_mutex;
+            std::size_t m_fileSize = 0;
+            std::size_t m_nbChunks = 0;
+            std::size_t m_next = 0;
+            std::size_t m_inflight = 0;
+            std::size_t m_completed = 0;
+            std::vector<std::size_t> m_sent;
+            std::size_t m_totalSent = 0;
+            std::optional<Response> m_failure;
+            Response m_last;
+
+            // Accounts for a chunk that won't be sent again, and returns the answer once none is left in flight
+            std::optional<Response> settle(const std::optional<Response>& failure)
+            {
+                if (failure.has_value() && false == m_failure.has_value()) m_failure = failure;
+                --m_inflight;
+                if (0 == m_inflight && (m_failure.has_value() || m_completed == m_nbChunks)) return m_failure.value_or(m_last);
+                return std::nullopt;
+            }
+        };
+
+        auto prom = std::make_shared<std::promise<Response>>();
+        std::shared_future<Response> res = prom->get_future();
+
+        std::error_code ec;
+        auto state = std::make_shared<Upload>();
+        state->m_fileSize = static_cast<std::size_t>(fs::file_size(path, ec));
+        if (ec)
+        {
+            Response response;
+            response.m_reason = "Failed to upload " + path.string() + "; " + ec.message();
+            prom->set_value(response);
+            return res;
+        }
+
+        state->m_nbChunks = std::max<std::size_t>(1, (state->m_fileSize + upload.chunkSize() - 1) / upload.chunkSize());
+        state->m_sent.resize(state->m_nbChunks, 0);
+
+        auto policy = (m_options + upload.options()).retryPolicy().value_or(RetryPolicy{});
+
+        // Each chunk is sent by a fresh request so that it can be retried on its own.
+        // Only pending chunk handlers and retry timers own the driver functions, which are weakly bound to each other
+        using TSendChunk = std::function<void(std::size_t, unsigned int)>;
+        using TLaunch = std::function<void()>;
+        auto sendChunk = std::make_shared<TSendChunk>();
+        auto launch = std::make_shared<TLaunch>();
+
+        *sendChunk = [weak = weak_from_this(), state, prom, weakLaunch = std::weak_ptr<TLaunch>{ launch }, weakSendChunk = std::weak_ptr<TSendChunk>{ sendChunk }, target, path, upload, policy](std::size_t index, unsigned int attempt)
+        {
+            auto self = weak.lock();
+            auto launch = weakLaunch.lock();
+            auto sendChunk = weakSendChunk.lock();
+            if (nullptr == self || nullptr == launch || nullptr == sendChunk) return;
+
+            auto offset = index * upload.chunkSize();
+            auto size = std::min(upload.chunkSize(), state->m_fileSize - offset);
+
+            // The file may have shrunk or vanished since the upload started
+            std::optional<Response> failure;
+            FormData form;
+            try
+            {
+                form.add("chunkIndex", std::to_string(index));
+                form.add("chunkCount", std::to_string(state->m_nbChunks));
+                form.add("chunkOffset", std::to_string(offset));
+                form.add("totalSize", std::to_string(state->m_fileSize));
+                form.add(upload.field(), path.filename().string(), path, offset, size);
+            }
+            catch (const std::exception& e)
+            {
+                failure = Response{};
+                failure->m_reason = "Failed to upload " + path.string() + "; " + e.what();
+            }
+
+            // Once the upload has failed, the chunks about to be sent are dropped
+            std::optional<Response> answer;
+            bool abandoned = false;
+            {
+                TLock lock{ state->m_mutex };
+                abandoned = failure.has_value() || state->m_failure.has_value();
+                if (abandoned) answer = state->settle(failure);
+            }
+
+            if (answer.has_value()) prom->set_value(answer.value());
+            if (abandoned) return;
+
+            auto options = upload.options();
+            if (upload.progress().has_value())
+            {
+                options.sendProgress([state, index, size, progress = upload.progress().value()](std::size_t total, std::size_t processed)
+                {
+                    TLock lock{ state->m_mutex };
+                    // Chunk progress counts the request head and multipart framing, scale it to the file bytes
+                    auto sent = 0 == total ? size : std::min(size, static_cast<std::size_t>(static_cast<double>(size) * processed / total));
+                    state->m_totalSent += sent - std::min(sent, state->m_sent[index]);
+                    state->m_sent[index] = std::max(sent, state->m_sent[index]);
+                    progress(state->m_fileSize, state->m_totalSent);
+                });
+            }
+
+            auto req = std::make_shared<RequestImpl>(upload.verb(), target, self);
+            req->options(options);
+            req->body(std::move(form));
+
+            self->submit(req, [weak, state, prom, launch, sendChunk, index, attempt, upload, policy](const Response& response)
+            {
+                auto status = response.status();
+                bool success = status >= 200 && status < 300;
+                bool retryable = castFromEnum(boost::beast::http::status::unknown) == status || policy.isRetryable(status);
+                bool retry = false;
+                std::optional<Response> answer;
+                {
+                    TLock lock{ state->m_mutex };
+                    if (success)
+                    {
+                        ++state->m_completed;
+                        state->m_last = response;
+                        answer = state->settle(std::nullopt);
+                    }
+                    else if (retryable && attempt < upload.maxAttempts() && false == state->m_failure.has_value())
+                    {
+                        retry = true;
+                    }
+                    else
+                    {
+                        answer = state->settle(response);
+                    }
+                }
+
+                if (answer.has_value()) return prom->set_value(answer.value());
+                if (false == retry) return (*launch)();
+
+                auto delay = policy.backoff(attempt - 1);
+                auto retryAfter = parseHttpDelay(response.header("retry-after"));
+                if (retryAfter.has_value() && policy.honourRetryAfter()) delay = std::max(delay, retryAfter.value());
+
+                auto self = weak.lock();
+                if (nullptr == self) return;
+
+                // The pending timer is then the only owner of the driver functions
+                auto timer = std::make_shared<boost::asio::steady_timer>(boost::asio::make_strand(self->m_ioc), delay);
+                timer->async_wait([timer, launch, sendChunk, index, attempt](const boost::beast::error_code&)
+                {
+                    (*sendChunk)(index, attempt + 1);
+                });
+            });
+        };
+
+        *launch = [state, sendChunk, parallelism = upload.parallelism()]()
+        {
+            std::vector<std::size_t> chunks;
+            {
+                TLock lock{ state->m_mutex };
+                while (state->m_inflight < parallelism && state->m_next < state->m_nbChunks && false == state->m_failure.has_value())
+                {
+                    ++state->m_inflight;
+                    chunks.push_back(state->m_next++);
+                }
+            }
+
+            for (auto index : chunks) (*sendChunk)(index, 1);
+        };
+
+        (*launch)();
+
+        return res;
+    }
+
+    // Answers fresh hits directly, otherwise makes the request conditional and stores its answer
+    inline bool ClientImpl::fromCache(TRequestImplPtr req, TResponseHandler& handler, Options& options) const
+    {
+        if (nullptr == m_cache && nullptr == m_diskCache) return false;
+        if (boost::beast::http::verb::get != req->m_verb || false == req->m_body.isEmpty() || options.range().has_value()) return false;
+
+        // Authorized answers are keyed by a digest of the credentials, so that they are never served to another user
+        auto authorization = options.auth().value_or("");
+        for (const auto& [name, value] : req->m_headers)
+        {
+            if (boost::algorithm::iequals(name, "authorization")) authorization = value;
+        }
+
+        auto key = req->m_target;
+        if (false == authorization.empty()) key += "\n" + std::to_string(std::hash<std::string>{}(authorization));
+        auto diskKey = m_endpoints.at(0).host + ":" + m_endpoints.at(0).port + key;
+        auto fileOut = options.fileOut();
+        auto tempDir = options.tempDir().value_or(std::filesystem::temp_directory_path());
+
+        // Only the disk cache hands out files, the memory one can't answer a download into fileOut
+        auto memory = nullptr != m_cache && false == fileOut.has_value();
+
+        std::optional<ResponseCache::Lookup> cached;
+        if (true == memory) cached = m_cache->lookup(key, req->m_headers);
+        if (false == cached.has_value() && nullptr != m_diskCache) cached = m_diskCache->lookup(diskKey, req->m_headers, fileOut, tempDir);
+
+        if (cached.has_value() && true == cached->fresh)
+        {
+            handler(cached->response);
+            return true;
+        }
+
+        if (true == cached.has_value()) options.validators(ResponseCache::validators(cached->response));
+
+        handler = [weak = weak_from_this(), key, diskKey, memory, authorized = false == authorization.empty(), fileOut, tempDir, headers = req->m_headers, handler](const Response& response)
+        {
+            std::optional<Response> stored;
+
+            // The client must not be kept alive while the caller is being answered
+            if (auto self = weak.lock())
+            {
+                if (castFromEnum(boost::beast::http::status::not_modified) == response.status())
+                {
+                    if (true == memory) stored = self->m_cache->revalidate(key, response);
+                    if (false == stored.has_value() && nullptr != self->m_diskCache) stored = self->m_diskCache->revalidate(diskKey, response, fileOut, tempDir);
+                }
+
+                if (false == stored.has_value() && (false == authorized || true == ResponseCache::isPublic(response)))
+                {
+                    if (true == memory) self->m_cache->store(key, headers, response);
+                    if (nullptr != self->m_diskCache) self->m_diskCache->store(diskKey, headers, response);
+                }
+            }
+
+            handler(stored.has_value() ? stored.value() : response);
+        };
+
+        return false;
+    }
+
+    // Identical idempotent requests in flight share the answer of the first one
+    inline bool ClientImpl::joinFlight(TRequestImplPtr req, TResponseHandler& handler, const Options& options) const
+    {
+        if (false == options.singleFlight().value_or(false)) return false;
+        if (false == RetryPolicy::isIdempotent(req->m_verb) || false == req->m_body.isEmpty()) return false;
+
+        // Each download into fileOut must land at its own path, so those are never shared
+        if (options.fileOut().has_value()) return false;
+
+        auto key = std::string{ boost::beast::http::to_string(req->m_verb) } + " " + req->m_target + "\n" + options.auth().value_or("");
+        if (options.range().has_value())
+        {
+            const auto& range = options.range().value();
+            key += "\nrange: " + std::to_string(range.first) + "-" + (range.last.has_value() ? std::to_string(range.last.value()) : std::string{});
+        }
+        for (const auto& [name, value] : req->m_headers)
+        {
+            // Credentials always tell requests apart, whatever headers were selected
+            auto credential = boost::algorithm::iequals(name, "authorization") || boost::algorithm::iequals(name, "proxy-authorization") || boost::algorithm::iequals(name, "cookie");
+            const auto& selected = options.singleFlightHeaders();
+            if (false == credential && selected.has_value() && std::none_of(selected->begin(), selected->end(), [&name](const auto& other) { return boost::algorithm::iequals(name, other); })) continue;
+            key += "\n" + boost::algorithm::to_lower_copy(name) + ": " + value;
+        }
+
+        {
+            TLock lock{ m_flightsMutex };
+            auto it = m_flights.find(key);
+            if (it != m_flights.end())
+            {
+                it->second.push_back(Follower{ req, handler });
+                return true;
+            }
+
+            m_flights[key] = {};
+        }
+
+        handler = leadFlight(key, handler);
+
+        return false;
+    }
+
+    inline TResponseHandler ClientImpl::leadFlight(const std::string& key, TResponseHandler handler) const
+    {
+        return [weak = weak_from_this(), key, handler](const Response& response)
+        {
+            std::vector<Follower> followers;
+            if (auto self = weak.lock())
+            {
+                std::optional<Follower> next;
+                {
+                    TLock lock{ self->m_flightsMutex };
+                    auto it = self->m_flights.find(key);
+                    if (it != self->m_flights.end())
+                    {
+                        // A canceled leader hands the flight over to its first follower instead of failing them all
+                        if (StatusCanceled == response.status() && false == it->second.empty())
+                        {
+                            next = std::move(it->second.front());
+                            it->second.erase(it->second.begin());
+                        }
+                        else
+                        {
+                            followers = std::move(it->second);
+                            self->m_flights.erase(it);
+                        }
+                    }
+                }
+
+                if (next.has_value()) self->start(next->req, self->leadFlight(key, next->handler), self->m_options + next->req->options());
+            }
+
+            for (auto& follower : followers)
+            {
+                // Every caller owns its downloaded file, so followers get their own link to it
+                if (response.body().isPath())
+                {
+                    Response copy = response;
+                    copy.m_tempPath = response.body().path().parent_path() / boost::uuids::to_string(boost::uuids::random_generator()());
+                    std::error_code ec;
+                    fs::create_hard_link(response.body().path(), copy.m_tempPath, ec);
+                    if (ec) fs::copy_file(response.body().path(), copy.m_tempPath, ec);
+                    copy.m_body = copy.m_tempPath;
+                    follower.handler(copy);
+                }
+                else
+                {
+                    follower.handler(response);
+                }
+            }
+
+            handler(response);
+        };
+    }
+
+    inline CacheStats ClientImpl::cacheStats() const
+    {
+        CacheStats stats;
+        for (const auto& cacheStats : { nullptr != m_cache ? m_cache->stats() : CacheStats{}, nullptr != m_diskCache ? m_diskCache->stats() : CacheStats{} })
+        {
+            stats.hits += cacheStats.hits;
+            stats.misses += cacheStats.misses;
+            stats.revalidations += cacheStats.revalidations;
+            stats.entries += cacheStats.entries;
+            stats.bytes += cacheStats.bytes;
+        }
+
+        return stats;
+    }
+
+    inline void ClientImpl::start(TRequestImplPtr req, TResponseHandler handler, const Options& options) const
+    {
+        if (boost::beast::http::verb::get == req->m_verb && options.fileOut().has_value() && false == options.range().has_value())
+        {
+            if (options.parallelRanges().value_or(1) > 1) return download(req, handler, options);
+            if (true == options.resume().value_or(false)) return resume(req, handler, options);
+        }
+
+        if (options.hedged() && boost::beast::http::verb::get == req->m_verb)
+        {
+            hedge(req, handler, options);
+        }
+        else
+        {
+            dispatch(req, handler, options, 0);
+        }
+    }
+
+    inline void ClientImpl::resume(TRequestImplPtr req, TResponseHandler handler, const Options& options) const
+    {
+        std::error_code ec;
+
+        // A parallel download left unfinished has the full size without the content
+        if (fs::exists(rangesMarker(options.fileOut().value()), ec))
+        {
+            fs::remove(options.fileOut().value(), ec);
+            fs::remove(rangesMarker(options.fileOut().value()), ec);
+        }
+
+        auto size = fs::file_size(options.fileOut().value(), ec);
+        if (ec || 0 == size)
+        {
+            dispatch(req, handler, options, 0);
+            return;
+        }
+
+        auto resumed = options;
+        resumed.range({ size });
+
+        dispatch(req, [handler, size, path = options.fileOut().value()](const Response& response)
+        {
+            auto status = response.status();
+            if (castFromEnum(boost::beast::http::status::partial_content) == status) return handler(whole(response));
+
+            // The file was already complete
+            if (castFromEnum(boost::beast::http::status::range_not_satisfiable) == status && rangeTotal(response) == size)
+            {
+                auto complete = whole(response);
+                complete.m_body = path;
+                complete.m_tempPath = path;
+                return handler(complete);
+            }
+
+            handler(response);
+        }, resumed, 0);
+    }
+
+    // Probes the size with the first byte, then fetches the rest as parallel ranges into the preallocated file
+    inline void ClientImpl::download(TRequestImplPtr req, TResponseHandler handler, const Options& options) const
+    {
+        struct Download
+        {
+            TMutex m_mutex;
+            std::size_t m_remaining = 0;
+            std::optional<Response> m_failure;
+        };
+
+        auto probe = options;
+        probe.range({ 0, 0 });
+
+        dispatch(req, [weak = weak_from_this(), req, handler, options](const Response& response)
+        {
+            auto total = rangeTotal(response);
+            auto self = weak.lock();
+            if (nullptr == self || castFromEnum(boost::beast::http::status::partial_content) != response.status() || false == total.has_value() || total.value() <= 1)
+            {
+                self.reset();
+                return handler(castFromEnum(boost::beast::http::status::partial_content) == response.status() ? whole(response) : response);
+            }
+
+            // The marker tells resume() that the preallocated file isn't complete until every range succeeded
+            auto path = options.fileOut().value();
+            std::ofstream{ rangesMarker(path) };
+
+            std::error_code ec;
+            fs::resize_file(path, total.value(), ec);
+            if (ec)
+            {
+                fs::remove(rangesMarker(path), ec);
+                self.reset();
+                Response failure = response;
+                failure.m_status = castFromEnum(boost::beast::http::status::unknown);
+                failure.m_reason = "Failed to preallocate " + options.fileOut().value().string() + "; " + ec.message();
+                return handler(failure);
+            }
+
+            auto nbRanges = static_cast<std::uint64_t>(options.parallelRanges().value());
+            auto rangeSize = (total.value() - 1 + nbRanges - 1) / nbRanges;
+            auto state = std::make_shared<Download>();
+            state->m_remaining = static_cast<std::size_t>((total.value() - 1 + rangeSize - 1) / rangeSize);
+
+            TResponseHandler part = [state, handler, path, result = whole(response)](const Response& partResponse)
+            {
+                std::optional<Response> answer;
+                bool failed = false;
+                {
+                    TLock lock{ state->m_mutex };
+                    if (castFromEnum(boost::beast::http::status::partial_content) != partResponse.status() && false == state->m_failure.has_value())
+                    {
+                        state->m_failure = partResponse;
+                    }
+                    if (0 == --state->m_remaining) answer = state->m_failure.value_or(result);
+                    failed = state->m_failure.has_value();
+                }
+
+                if (false == answer.has_value()) return;
+
+                std::error_code ignored;
+                if (failed) fs::remove(path, ignored);
+                fs::remove(rangesMarker(path), ignored);
+                handler(answer.value());
+            };
+
+            for (auto first = std::uint64_t{ 1 }; first < total.value(); first += rangeSize)
+            {
+                auto rangeOptions = options;
+                rangeOptions.range({ first, std::min(first + rangeSize, total.value()) - 1 });
+                self->dispatch(req->split(), part, rangeOptions, 0);
+            }
+        }, probe, 0);
+    }
+
+    inline std::optional<std::uint64_t> ClientImpl::rangeTotal(const Response& response)
+    {
+        auto contentRange = response.header("content-range");
+        auto slash = contentRange.rfind('/');
+        if (std::string::npos == slash || slash + 1 == contentRange.size() || '*' == contentRange[slash + 1]) return std::nullopt;
+        return std::strtoull(contentRange.c_str() + slash + 1, nullptr, 10);
+    }
+
+    inline fs::path ClientImpl::rangesMarker(const fs::path& path)
+    {
+        return path.parent_path() / (path.filename().string() + ".ranges");
+    }
+
+    // Reports a file completed from ranges as a plain 200 answer
+    inline Response ClientImpl::whole(const Response& response)
+    {
+        Response result = response;
+        result.m_status = castFromEnum(boost::beast::http::status::ok);
+        result.m_reason = std::string{ boost::beast::http::obsolete_reason(boost::beast::http::status::ok) };
+        result.m_headers.erase("content-range");
+        result.m_headers.erase("content-length");
+        return result;
+    }
+
+    inline ClientImpl::TSessionPtr ClientImpl::dispatch(TRequestImplPtr req, TResponseHandler handler, const Options& options, unsigned int attempt, TDispatchHook hook) const
+    {
+        auto index = m_endpoints.acquire();
+
+        // Skip endpoints whose circuit is open, failing fast when none is left
+        for (std::size_t tries = 1; nullptr != circuitBreaker(index) && false == circuitBreaker(index)->tryAcquire(); ++tries)
+        {
+            m_endpoints.release(index);
+
+            if (tries >= m_endpoints.size())
+            {
+                Response response;
+                response.handleCircuitOpen(m_endpoints.at(index).host + ":" + m_endpoints.at(index).port);
+                handler(response);
+                return nullptr;
+            }
+
+            index = m_endpoints.acquire();
+        }
+
+        const auto& endpoint = m_endpoints.at(index);
+
         TSessionPtr session;
-        if (m_isSsl)
+        if (endpoint.isSsl)
         {
-            session = std::make_shared<SessionSsl>(shared_from_this(), m_ioc, m_host, m_port, options);
+            session = std::make_shared<SessionSsl>(shared_from_this(), m_ioc, endpoint, index, options);
         }
         else
         {
-            session = std::make_shared<SessionPlain>(shared_from_this(), m_ioc, m_host, m_port, options);
+            session = std::make_shared<SessionPlain>(shared_from_this(), m_ioc, endpoint, index, options);
         }
 
         if (nullptr != session)
         {
+            if (hook) hook(session);
+
             TLock lock{ m_mutex };
-            req->m_sessionId = session->id();
             m_sessions[session->id()] = session;
-            session->run(req, prom);
+            session->run(req, handler, attempt, hook);
         }
         else
         {
-            prom.set_value(Response{});
+            release(index, false, std::chrono::milliseconds::zero());
+            handler(Response{});
         }
 
-        return res;
+        return session;
+    }
+
+    inline void ClientImpl::hedge(TRequestImplPtr req, TResponseHandler handler, const Options& options) const
+    {
+        struct Hedge
+        {
+            TMutex m_mutex;
+            bool m_done = false;
+            unsigned int m_attempts = 1;
+            unsigned int m_failures = 0;
+            std::vector<std::weak_ptr<ISession>> m_sessions;
+        };
+
+        auto state = std::make_shared<Hedge>();
+
+        // The first success wins and the other attempt gets canceled. A failure is only answered once
+        // every attempt launched has failed
+        TResponseHandler first = [state, handler](const Response& response)
+        {
+            auto status = response.status();
+            bool failed = castFromEnum(boost::beast::http::status::unknown) == status || status >= 500;
+            {
+                TLock lock{ state->m_mutex };
+                if (true == state->m_done) return;
+                if (true == failed && ++state->m_failures < state->m_attempts) return;
+                state->m_done = true;
+            }
+
+            handler(response);
+
+            TLock lock{ state->m_mutex };
+            for (auto& weak : state->m_sessions)
+            {
+                if (auto session = weak.lock()) session->cancel();
+            }
+        };
+
+        // Every session of an attempt is tracked, the ones dispatched by its retries included
+        TDispatchHook track = [state](const TSessionPtr& session)
+        {
+            TLock lock{ state->m_mutex };
+            state->m_sessions.push_back(session);
+
+            // The other attempt may have won while this one was being dispatched
+            if (true == state->m_done) session->cancel();
+        };
+
+        dispatch(req, first, options, 0, track);
+
+        auto delay = std::chrono::milliseconds(options.hedgeDelay().value_or(Options::DefaultHedgeDelay));
+        if (options.hedgePercentile().has_value())
+        {
+            delay = m_headerLatency.percentile(options.hedgePercentile().value()).value_or(delay);
+        }
+
+        auto timer = std::make_shared<boost::asio::steady_timer>(boost::asio::make_strand(m_ioc), delay);
+        timer->async_wait([weak = weak_from_this(), timer, state, req, first, track, options](const boost::beast::error_code& ec)
+        {
+            auto self = weak.lock();
+            if (ec || nullptr == self) return;
+
+            {
+                TLock lock{ state->m_mutex };
+                if (state->m_done) return;
+
+                for (auto& weakSession : state->m_sessions)
+                {
+                    auto session = weakSession.lock();
+                    if (nullptr != session && session->headerReceived()) return;
+                }
+
+                ++state->m_attempts;
+            }
+
+            // Dispatched outside the lock, since a fast failure (open circuits) calls first inline
+            self->dispatch(req, first, options, 0, track);
+        });
     }
 }
 
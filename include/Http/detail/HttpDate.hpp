@@ -0,0 +1,69 @@
+#ifndef HTTP_DATE_HPP_INCLUDED
+#define HTTP_DATE_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+
+namespace Http::detail
+{
+    using TTimePoint = std::chrono::system_clock::time_point;
+
+    // Days since 1970-01-01 of a proleptic gregorian date (H. Hinnant's days_from_civil)
+    constexpr long long daysFromCivil(long long year, unsigned int month, unsigned int day)
+    {
+        year -= month <= 2 ? 1 : 0;
+        const long long era = (year >= 0 ? year : year - 399) / 400;
+        const unsigned int yoe = static_cast<unsigned int>(year - era * 400);
+        const unsigned int doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+        const unsigned int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<long long>(doe) - 719468;
+    }
+
+    // Parses an IMF-fixdate as found in Date, Expires, Last-Modified or Retry-After headers,
+    // e.g. "Sun, 06 Nov 1994 08:49:37 GMT"
+    inline std::optional<TTimePoint> parseHttpDate(const std::string& value)
+    {
+        static constexpr char const* Months[] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+
+        char monthName[4] = {};
+        char zone[4] = {};
+        unsigned int day = 0, year = 0, hours = 0, minutes = 0, seconds = 0;
+
+        auto comma = value.find(',');
+        if (std::string::npos == comma) return std::nullopt;
+
+        if (7 != std::sscanf(value.c_str() + comma + 1, " %2u %3s %4u %2u:%2u:%2u %3s", &day, monthName, &year, &hours, &minutes, &seconds, zone))
+        {
+            return std::nullopt;
+        }
+
+        if (0 != std::strcmp(zone, "GMT")) return std::nullopt;
+
+        unsigned int month = 0;
+        while (month < 12 && 0 != std::strcmp(Months[month], monthName)) ++month;
+        if (12 == month || 0 == day || day > 31 || hours > 23 || minutes > 59 || seconds > 60) return std::nullopt;
+
+        auto days = daysFromCivil(year, month + 1, day);
+        auto since = std::chrono::hours(days * 24 + hours) + std::chrono::minutes(minutes) + std::chrono::seconds(seconds);
+
+        return TTimePoint{ std::chrono::duration_cast<TTimePoint::duration>(since) };
+    }
+
+    // Parses a delay expressed either in seconds or as an HTTP date (Retry-After)
+    inline std::optional<std::chrono::milliseconds> parseHttpDelay(const std::string& value)
+    {
+        if (value.empty()) return std::nullopt;
+
+        if (std::all_of(value.begin(), value.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); }))
+        {
+            return std::chrono::seconds(std::strtoull(value.c_str(), nullptr, 10));
+        }
+
+        auto date = parseHttpDate(value);
+        if (false == date.has_value()) return std::nullopt;
+
+        auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(date.value() - std::chrono::system_clock::now());
+        return std::max(delay, std::chrono::milliseconds::zero());
+    }
+}
+
+#endif
@@ -0,0 +1,362 @@
+#ifndef HTTP_DISK_CACHE_HPP_INCLUDED
+#define HTTP_DISK_CACHE_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+#include "Http/HttpCache.hpp"
+#include "Http/HttpResponse.hpp"
+#include "Http/detail/HttpResponseCache.hpp"
+
+namespace Http::detail
+{
+    // Persistent cache of file and binary responses, indexed by a JSON file kept next to the cached bodies. Changes
+    // are appended to a journal that is folded into the index once it grows
+    class DiskCache
+    {
+    public:
+        using THeaders = std::map<std::string, std::string>;
+
+    private:
+        using TMutex = std::mutex;
+        using TLock = std::lock_guard<TMutex>;
+        using TClock = std::chrono::system_clock;
+
+        struct Entry
+        {
+            std::string file;
+            std::size_t size = 0;
+            bool binary = false;
+            TClock::time_point expires = {};
+            TClock::time_point lastUsed = {};
+            THeaders headers;
+            THeaders vary;
+        };
+
+        using TEntries = std::map<std::string, Entry>;
+
+        mutable TMutex m_mutex;
+        fs::path m_dir;
+        std::size_t m_capacity;
+        TEntries m_entries;
+        std::size_t m_size;
+        CacheStats m_stats;
+        std::size_t m_journaled;
+
+    public:
+        static constexpr char const* IndexName = "index.json";
+        static constexpr char const* JournalName = "index.journal";
+        static constexpr std::size_t MaxJournaled = 64;
+
+    public:
+        DiskCache(const fs::path& dir, std::size_t capacity)
+            : m_mutex{}
+            , m_dir{ dir }
+            , m_capacity{ capacity }
+            , m_entries{}
+            , m_size{ 0 }
+            , m_stats{}
+            , m_journaled{ 0 }
+        {
+            std::error_code ec;
+            fs::create_directories(m_dir, ec);
+            load();
+        }
+
+        virtual ~DiskCache()
+        {
+            if (m_journaled > 0) save();
+        }
+
+        DiskCache(const DiskCache& other) = delete;
+        DiskCache& operator=(const DiskCache& other) = delete;
+        DiskCache(DiskCache&& other) = delete;
+        DiskCache& operator=(DiskCache&& other) = delete;
+
+        CacheStats stats() const
+        {
+            TLock lock{ m_mutex };
+            auto stats = m_stats;
+            stats.entries = m_entries.size();
+            stats.bytes = m_size;
+            return stats;
+        }
+
+        // Fresh hits are copied to fileOut, or handed out the way they were received. Stale ones only carry the
+        // stored headers, enough to revalidate them
+        std::optional<ResponseCache::Lookup> lookup(const std::string& key, const THeaders& requestHeaders, const std::optional<fs::path>& fileOut, const fs::path& tempDir)
+        {
+            TLock lock{ m_mutex };
+
+            auto it = m_entries.find(key);
+            if (it == m_entries.end() || false == ResponseCache::matches(it->second.vary, requestHeaders)) return std::nullopt;
+
+            std::error_code ec;
+            if (false == fs::exists(m_dir / it->second.file, ec))
+            {
+                erase(it);
+                return std::nullopt;
+            }
+
+            it->second.lastUsed = TClock::now();
+            if (TClock::now() >= it->second.expires) return ResponseCache::Lookup{ headersOf(it->second), false };
+
+            auto response = materialize(it->second, fileOut, tempDir);
+            if (false == response.has_value())
+            {
+                erase(it);
+                return std::nullopt;
+            }
+
+            ++m_stats.hits;
+            return ResponseCache::Lookup{ response.value(), true };
+        }
+
+        void store(const std::string& key, const THeaders& requestHeaders, const Response& response)
+        {
+            if (false == response.body().isPath() && false == response.body().isBinary()) return;
+
+            auto expires = ResponseCache::expiry(response);
+
+            Entry entry;
+            entry.file = boost::uuids::to_string(boost::uuids::random_generator()());
+            entry.binary = response.body().isBinary();
+            entry.lastUsed = TClock::now();
+            entry.headers = response.headers();
+            entry.vary = ResponseCache::varyValues(response.header("vary"), requestHeaders);
+
+            // The caller keeps its file, so the cache needs a copy of its own that later writes can't reach
+            std::error_code ec;
+            if (expires.has_value())
+            {
+                entry.expires = expires.value();
+                if (true == entry.binary)
+                {
+                    entry.size = response.body().binary().size();
+                    if (false == response.body().save(m_dir / entry.file)) ec = std::make_error_code(std::errc::io_error);
+                }
+                else if (true == fs::copy_file(response.body().path(), m_dir / entry.file, fs::copy_options::overwrite_existing, ec))
+                {
+                    entry.size = static_cast<std::size_t>(fs::file_size(m_dir / entry.file, ec));
+                }
+                if (ec || entry.size > m_capacity)
+                {
+                    fs::remove(m_dir / entry.file, ec);
+                    expires.reset();
+                }
+            }
+
+            TLock lock{ m_mutex };
+
+            ++m_stats.misses;
+
+            auto it = m_entries.find(key);
+            if (it != m_entries.end()) erase(it);
+            if (false == expires.has_value()) return;
+
+            m_size += entry.size;
+            journal(key, &entry);
+            m_entries[key] = std::move(entry);
+
+            evict();
+        }
+
+        // Refreshes an entry from a 304 answer and returns the stored response
+        std::optional<Response> revalidate(const std::string& key, const Response& notModified, const std::optional<fs::path>& fileOut, const fs::path& tempDir)
+        {
+            TLock lock{ m_mutex };
+
+            auto it = m_entries.find(key);
+            if (it == m_entries.end()) return std::nullopt;
+
+            auto& entry = it->second;
+            for (const auto& [name, value] : notModified.headers())
+            {
+                if ("content-length" != name) entry.headers[name] = value;
+            }
+
+            auto response = materialize(entry, fileOut, tempDir);
+            if (false == response.has_value())
+            {
+                erase(it);
+                return std::nullopt;
+            }
+
+            auto expires = ResponseCache::expiry(response.value());
+            if (expires.has_value()) entry.expires = expires.value();
+            entry.lastUsed = TClock::now();
+
+            ++m_stats.revalidations;
+            journal(key, &entry);
+            return response;
+        }
+
+    private:
+        static Response headersOf(const Entry& entry)
+        {
+            Response response;
+            response.m_status = castFromEnum(boost::beast::http::status::ok);
+            response.m_reason = std::string{ boost::beast::http::obsolete_reason(boost::beast::http::status::ok) };
+            response.m_headers = entry.headers;
+            return response;
+        }
+
+        // Copied aside then renamed, so that the caller never observes a partial body nor shares it with the cache
+        std::optional<Response> materialize(const Entry& entry, const std::optional<fs::path>& fileOut, const fs::path& tempDir) const
+        {
+            if (true == entry.binary && false == fileOut.has_value())
+            {
+                std::ifstream file{ m_dir / entry.file, std::ios::binary };
+                TBinary binary(entry.size);
+                if (false == file.read(reinterpret_cast<char*>(binary.data()), static_cast<std::streamsize>(binary.size())).good()) return std::nullopt;
+
+                auto response = headersOf(entry);
+                response.m_body = binary;
+                return response;
+            }
+
+            auto path = fileOut.value_or(tempDir / boost::uuids::to_string(boost::uuids::random_generator()()));
+            auto part = path.parent_path() / (path.filename().string() + "." + boost::uuids::to_string(boost::uuids::random_generator()()) + ".part");
+
+            std::error_code ec;
+            fs::copy_file(m_dir / entry.file, part, fs::copy_options::overwrite_existing, ec);
+            if (!ec) fs::rename(part, path, ec);
+            if (ec)
+            {
+                fs::remove(part, ec);
+                return std::nullopt;
+            }
+
+            auto response = headersOf(entry);
+            response.m_body = path;
+            response.m_tempPath = path;
+            return response;
+        }
+
+        void erase(TEntries::iterator it)
+        {
+            std::error_code ec;
+            fs::remove(m_dir / it->second.file, ec);
+            m_size -= std::min(m_size, it->second.size);
+            journal(it->first, nullptr);
+            m_entries.erase(it);
+        }
+
+        void evict()
+        {
+            while (m_size > m_capacity && false == m_entries.empty())
+            {
+                auto oldest = std::min_element(m_entries.begin(), m_entries.end(), [](const auto& lhs, const auto& rhs) {
+                    return lhs.second.lastUsed < rhs.second.lastUsed;
+                });
+                erase(oldest);
+            }
+        }
+
+        static std::int64_t toMs(TClock::time_point time)
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+        }
+
+        static TClock::time_point fromMs(std::int64_t ms)
+        {
+            return TClock::time_point{ std::chrono::duration_cast<TClock::duration>(std::chrono::milliseconds(ms)) };
+        }
+
+        static nlohmann::json toJson(const Entry& entry)
+        {
+            return {
+                { "file", entry.file },
+                { "size", entry.size },
+                { "binary", entry.binary },
+                { "expires", toMs(entry.expires) },
+                { "lastUsed", toMs(entry.lastUsed) },
+                { "headers", entry.headers },
+                { "vary", entry.vary }
+            };
+        }
+
+        static Entry fromJson(const nlohmann::json& value)
+        {
+            Entry entry;
+            entry.file = value.value("file", std::string{});
+            entry.size = value.value("size", std::size_t{ 0 });
+            entry.binary = value.value("binary", false);
+            entry.expires = fromMs(value.value("expires", std::int64_t{ 0 }));
+            entry.lastUsed = fromMs(value.value("lastUsed", std::int64_t{ 0 }));
+            entry.headers = value.value("headers", THeaders{});
+            entry.vary = value.value("vary", THeaders{});
+            return entry;
+        }
+
+        void load()
+        {
+            TEntries entries;
+
+            std::ifstream file{ m_dir / IndexName };
+            auto index = file.is_open() ? nlohmann::json::parse(file, nullptr, false) : nlohmann::json{};
+            if (index.is_object())
+            {
+                for (const auto& [key, value] : index.items()) entries[key] = fromJson(value);
+            }
+
+            // Replays the changes made since the index was last written, up to a torn last line
+            std::ifstream journal{ m_dir / JournalName };
+            for (std::string line; std::getline(journal, line);)
+            {
+                auto record = nlohmann::json::parse(line, nullptr, false);
+                if (record.is_discarded() || false == record.is_object()) break;
+
+                auto key = record.value("key", std::string{});
+                if (record.contains("entry")) entries[key] = fromJson(record["entry"]);
+                else entries.erase(key);
+            }
+
+            for (auto& [key, entry] : entries)
+            {
+                std::error_code ec;
+                if (entry.file.empty() || false == fs::exists(m_dir / entry.file, ec)) continue;
+
+                m_size += entry.size;
+                m_entries[key] = std::move(entry);
+            }
+
+            evict();
+            save();
+        }
+
+        // Appends a change to the journal, or folds the journal into the index once it has grown enough
+        void journal(const std::string& key, const Entry* entry)
+        {
+            if (++m_journaled >= MaxJournaled) return save();
+
+            nlohmann::json record = { { "key", key } };
+            if (nullptr != entry) record["entry"] = toJson(*entry);
+
+            std::ofstream file{ m_dir / JournalName, std::ios::app };
+            if (false == file.is_open()) return save();
+            file << record.dump() << '\n';
+        }
+
+        // Written aside then renamed so that a crash never leaves a truncated index
+        void save()
+        {
+            nlohmann::json index = nlohmann::json::object();
+            for (const auto& [key, entry] : m_entries) index[key] = toJson(entry);
+
+            auto tmp = m_dir / (std::string{ IndexName } + ".tmp");
+            {
+                std::ofstream file{ tmp, std::ios::trunc };
+                if (false == file.is_open()) return;
+                file << index.dump();
+            }
+
+            std::error_code ec;
+            fs::rename(tmp, m_dir / IndexName, ec);
+            if (ec) return;
+
+            fs::remove(m_dir / JournalName, ec);
+            m_journaled = 0;
+        }
+    };
+}
+
+#endif
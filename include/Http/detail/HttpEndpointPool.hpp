@@ -0,0 +1,166 @@
+#ifndef HTTP_ENDPOINT_POOL_HPP_INCLUDED
+#define HTTP_ENDPOINT_POOL_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+#include "Http/HttpOptions.hpp"
+
+namespace Http::detail
+{
+    struct Endpoint
+    {
+        static constexpr char const * const DefaultPlainPort = "80";
+        static constexpr char const * const DefaultSslPort = "443";
+        static constexpr char const * const Https = "https";
+        static constexpr char const * const HostPortScheme = R"(^(?:(http|https):\/\/)?([a-z0-9\-\.]+)(?::(\d+))?$)";
+
+        std::string host;
+        std::string port = DefaultPlainPort;
+        std::string address;
+        bool isSsl = false;
+
+        static Endpoint parse(const std::string& url)
+        {
+            Endpoint endpoint;
+
+            std::regex schemeHostPort{ HostPortScheme, std::regex_constants::ECMAScript | std::regex_constants::icase };
+
+            std::smatch match;
+            if (true == std::regex_match(url, match, schemeHostPort))
+            {
+                if (Https == boost::algorithm::to_lower_copy(match[1].str())) endpoint.isSsl = true;
+                endpoint.host = boost::algorithm::to_lower_copy(match[2].str());
+                endpoint.port = endpoint.isSsl ? DefaultSslPort : DefaultPlainPort;
+                if (!match[3].str().empty()) endpoint.port = match[3].str();
+            }
+
+            endpoint.address = endpoint.host;
+            return endpoint;
+        }
+    };
+
+    // Client-side load balancing across endpoints with passive health ejection
+    class EndpointPool
+    {
+    private:
+        using TMutex = std::mutex;
+        using TLock = std::lock_guard<TMutex>;
+        using TClock = std::chrono::steady_clock;
+
+        struct State
+        {
+            Endpoint endpoint;
+            std::size_t outstanding = 0;
+            unsigned int failures = 0;
+            TClock::time_point ejectedUntil = {};
+        };
+
+        mutable TMutex m_mutex;
+        std::vector<State> m_states;
+        LoadBalancing m_policy;
+        unsigned int m_ejectAfter;
+        std::chrono::milliseconds m_ejectionTime;
+        std::size_t m_next;
+        std::mt19937 m_generator;
+
+    public:
+        EndpointPool(const std::vector<Endpoint>& endpoints, const Options& options)
+            : m_mutex{}
+            , m_states{}
+            , m_policy{ options.loadBalancing().value_or(LoadBalancing::RoundRobin) }
+            , m_ejectAfter{ options.ejectAfter().value_or(Options::DefaultEjectAfter) }
+            , m_ejectionTime{ options.ejectionTime().value_or(Options::DefaultEjectionTime) }
+            , m_next{ 0 }
+            , m_generator{ std::random_device{}() }
+        {
+            for (const auto& endpoint : endpoints) m_states.push_back({ endpoint });
+        }
+
+        virtual ~EndpointPool() = default;
+        EndpointPool(const EndpointPool& other) = delete;
+        EndpointPool& operator=(const EndpointPool& other) = delete;
+        EndpointPool(EndpointPool&& other) = delete;
+        EndpointPool& operator=(EndpointPool&& other) = delete;
+
+        std::size_t size() const { return m_states.size(); }
+        const Endpoint& at(std::size_t index) const { return m_states[index].endpoint; }
+
+        std::size_t acquire()
+        {
+            TLock lock{ m_mutex };
+
+            auto now = TClock::now();
+            std::vector<std::size_t> healthy;
+            healthy.reserve(m_states.size());
+            for (std::size_t i = 0; i < m_states.size(); ++i)
+            {
+                if (m_states[i].ejectedUntil <= now) healthy.push_back(i);
+            }
+
+            // Fail open when every endpoint is ejected
+            if (healthy.empty())
+            {
+                for (std::size_t i = 0; i < m_states.size(); ++i) healthy.push_back(i);
+            }
+
+            std::size_t index = healthy.front();
+            switch (m_policy)
+            {
+            case LoadBalancing::RoundRobin:
+            {
+                index = healthy[m_next++ % healthy.size()];
+                break;
+            }
+            case LoadBalancing::LeastOutstanding:
+            {
+                // Rotate the starting point so that ties are spread across endpoints
+                auto offset = m_next++;
+                index = healthy[offset % healthy.size()];
+                for (std::size_t i = 1; i < healthy.size(); ++i)
+                {
+                    auto candidate = healthy[(offset + i) % healthy.size()];
+                    if (m_states[candidate].outstanding < m_states[index].outstanding) index = candidate;
+                }
+                break;
+            }
+            case LoadBalancing::PowerOfTwoChoices:
+            {
+                std::uniform_int_distribution<std::size_t> distribution{ 0, healthy.size() - 1 };
+                auto first = healthy[distribution(m_generator)];
+                auto second = healthy[distribution(m_generator)];
+                index = m_states[first].outstanding <= m_states[second].outstanding ? first : second;
+                break;
+            }
+            }
+
+            ++m_states[index].outstanding;
+            return index;
+        }
+
+        // Gives an endpoint back without reporting any outcome
+        void release(std::size_t index)
+        {
+            TLock lock{ m_mutex };
+            if (m_states[index].outstanding > 0) --m_states[index].outstanding;
+        }
+
+        void release(std::size_t index, bool success)
+        {
+            TLock lock{ m_mutex };
+
+            auto& state = m_states[index];
+            if (state.outstanding > 0) --state.outstanding;
+
+            if (success)
+            {
+                state.failures = 0;
+            }
+            else if (++state.failures >= m_ejectAfter)
+            {
+                state.failures = 0;
+                state.ejectedUntil = TClock::now() + m_ejectionTime;
+            }
+        }
+    };
+}
+
+#endif
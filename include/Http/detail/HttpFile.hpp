@@ -3,6 +3,7 @@
 
 #include "Http/HttpForwards.hpp"
 #include "Http/HttpOptions.hpp"
+#include "Http/detail/HttpAsyncFile.hpp"
 
 namespace Http::detail
 {
@@ -12,12 +13,23 @@ namespace Http::detail
         fs::path m_path;
         std::size_t m_write_buffer_size;
         boost::beast::flat_buffer m_write_buffer;
+        std::unique_ptr<boost::interprocess::mapped_region> m_region;
+        uint64_t m_preallocated;
+#if defined(HTTP_ENABLE_IO_URING)
+        // Carries the data transfers while boost::beast::file keeps serving the metadata
+        AsyncFile m_async;
+#endif
 
     public:
         HttpFile()
             : boost::beast::file{}
             , m_write_buffer_size{ Options::DefaultBufferSize }
             , m_write_buffer{ m_write_buffer_size }
+            , m_region{}
+            , m_preallocated{ 0 }
+#if defined(HTTP_ENABLE_IO_URING)
+            , m_async{}
+#endif
         {}
 
         virtual ~HttpFile() = default;
@@ -41,7 +53,15 @@ namespace Http::detail
 
         void close(boost::beast::error_code& ec)
         {
+            m_region.reset();
+#if defined(HTTP_ENABLE_IO_URING)
+            m_async.close(ec);
+            boost::beast::error_code closeError;
+            boost::beast::file::close(closeError);
+            if (!ec) ec = closeError;
+#else
             boost::beast::file::close(ec);
+#endif
         }
 
         void close()
@@ -54,6 +74,10 @@ namespace Http::detail
         {
             m_path = path;
             boost::beast::file::open(path, mode, ec);
+#if defined(HTTP_ENABLE_IO_URING)
+            // Opening the path again would fail for write_new, or truncate the file a second time
+            if (!ec) m_async.open(native_handle(), mode, ec);
+#endif
         }
 
         uint64_t size(boost::beast::error_code& ec) const
@@ -78,19 +102,96 @@ namespace Http::detail
             std::filesystem::remove(m_path, ec);
         }
 
+        // Reserves the disk blocks of the next length bytes in one go instead of growing the file write by write.
+        // The file size is kept so that appending still works. Best effort where unsupported
+        void preallocate(uint64_t length)
+        {
+#if defined(__linux__)
+            boost::beast::error_code ec;
+            auto offset = pos(ec);
+            if (ec || 0 == length) return;
+
+            if (0 == ::fallocate(boost::beast::file::native_handle(), FALLOC_FL_KEEP_SIZE, static_cast<off_t>(offset), static_cast<off_t>(length)))
+            {
+                m_preallocated = offset + length;
+            }
+#endif
+        }
+
+        // Closes a file whose transfer failed, releasing the preallocated blocks that were never written
+        void truncate()
+        {
+#if defined(__linux__)
+            boost::beast::error_code ec;
+            auto end = pos(ec);
+            if (!ec && m_preallocated > end)
+            {
+                ::fallocate(boost::beast::file::native_handle(), FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, static_cast<off_t>(end), static_cast<off_t>(m_preallocated - end));
+            }
+#endif
+            m_preallocated = 0;
+            close();
+        }
+
+        // Maps the whole file read-only for sequential access, returns false when it can't be mapped
+        bool map()
+        {
+            boost::beast::error_code ec;
+            auto length = size(ec);
+            if (ec || 0 == length) return false;
+
+            try
+            {
+                boost::interprocess::file_mapping mapping{ m_path.string().c_str(), boost::interprocess::read_only };
+                m_region = std::make_unique<boost::interprocess::mapped_region>(mapping, boost::interprocess::read_only, 0, static_cast<std::size_t>(length));
+                m_region->advise(boost::interprocess::mapped_region::advice_sequential);
+            }
+            catch (const boost::interprocess::interprocess_exception&)
+            {
+                m_region.reset();
+                return false;
+            }
+
+            return true;
+        }
+
+        bool is_mapped() const
+        {
+            return nullptr != m_region;
+        }
+
+        // Points into the mapping instead of copying, nothing is read from the file
+        boost::asio::const_buffer view(std::size_t offset, std::size_t n) const
+        {
+            offset = std::min(offset, m_region->get_size());
+            return { static_cast<const char*>(m_region->get_address()) + offset, std::min(n, m_region->get_size() - offset) };
+        }
+
         std::size_t pos(boost::beast::error_code& ec)
         {
+#if defined(HTTP_ENABLE_IO_URING)
+            return m_async.pos(ec);
+#else
             return boost::beast::file::pos(ec);
+#endif
         }
 
         void seek(std::size_t offset, boost::beast::error_code& ec)
         {
+#if defined(HTTP_ENABLE_IO_URING)
+            m_async.seek(offset, ec);
+#else
             boost::beast::file::seek(offset, ec);
+#endif
         }
 
         std::size_t read(void* buffer, std::size_t n, boost::beast::error_code& ec)
         {
+#if defined(HTTP_ENABLE_IO_URING)
+            auto nbRead = m_async.read(buffer, n, ec);
+#else
             auto nbRead = boost::beast::file::read(buffer, n, ec);
+#endif
 
             if (ec) return nbRead;
 
@@ -114,13 +215,21 @@ namespace Http::detail
         void finalize(boost::beast::error_code& ec)
         {
             flush(ec);
+#if defined(HTTP_ENABLE_IO_URING)
+            if (!ec) m_async.flush(ec);
+#endif
         }
 
     private:
         void flush(boost::beast::error_code& ec)
         {
             auto writableBuffer = m_write_buffer.data();
+#if defined(HTTP_ENABLE_IO_URING)
+            // Returns as soon as the buffer is handed to the ring
+            auto nbWritten = m_async.write(writableBuffer.data(), writableBuffer.size(), ec);
+#else
             auto nbWritten = boost::beast::file::write(writableBuffer.data(), writableBuffer.size(), ec);
+#endif
             m_write_buffer.consume(nbWritten);
         }
     };
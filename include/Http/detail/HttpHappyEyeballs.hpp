@@ -0,0 +1,179 @@
+#ifndef HTTP_HAPPY_EYEBALLS_HPP_INCLUDED
+#define HTTP_HAPPY_EYEBALLS_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+
+namespace Http::detail
+{
+    // Staggered parallel connection attempts as described by RFC 8305
+    class HappyEyeballs : public std::enable_shared_from_this<HappyEyeballs>
+    {
+    public:
+        using TSocket = boost::beast::tcp_stream::socket_type;
+        using TEndpoint = boost::asio::ip::tcp::endpoint;
+        using TEndpoints = std::vector<TEndpoint>;
+        using THandler = std::function<void(const boost::beast::error_code&, TSocket&&, const TEndpoint&)>;
+
+    private:
+        using TSocketPtr = std::unique_ptr<TSocket>;
+
+        boost::asio::any_io_executor m_executor;
+        TEndpoints m_endpoints;
+        std::vector<TSocketPtr> m_sockets;
+        boost::asio::steady_timer m_attemptTimer;
+        boost::asio::steady_timer m_timeoutTimer;
+        std::chrono::milliseconds m_attemptDelay;
+        std::size_t m_next;
+        std::size_t m_pending;
+        bool m_done;
+        boost::beast::error_code m_lastError;
+        THandler m_handler;
+
+    public:
+        HappyEyeballs() = delete;
+        HappyEyeballs(boost::asio::any_io_executor executor, const TEndpoints& endpoints, std::chrono::milliseconds attemptDelay)
+            : m_executor{ executor }
+            , m_endpoints{ endpoints }
+            , m_sockets{}
+            , m_attemptTimer{ executor }
+            , m_timeoutTimer{ executor }
+            , m_attemptDelay{ attemptDelay }
+            , m_next{ 0 }
+            , m_pending{ 0 }
+            , m_done{ false }
+            , m_lastError{ boost::asio::error::host_not_found }
+            , m_handler{}
+        {
+            m_sockets.reserve(m_endpoints.size());
+        }
+
+        virtual ~HappyEyeballs() = default;
+        HappyEyeballs(const HappyEyeballs& other) = delete;
+        HappyEyeballs& operator=(const HappyEyeballs& other) = delete;
+        HappyEyeballs(HappyEyeballs&& other) = delete;
+        HappyEyeballs& operator=(HappyEyeballs&& other) = delete;
+
+        // Alternates address families, starting with the preferred one
+        template <typename Results>
+        static TEndpoints interleave(const Results& results, bool preferIpv6)
+        {
+            TEndpoints preferred;
+            TEndpoints others;
+            for (const auto& result : results)
+            {
+                auto endpoint = TEndpoint{ result.endpoint() };
+                if (endpoint.address().is_v6() == preferIpv6) preferred.push_back(endpoint);
+                else others.push_back(endpoint);
+            }
+
+            TEndpoints endpoints;
+            endpoints.reserve(preferred.size() + others.size());
+            for (std::size_t i = 0; i < std::max(preferred.size(), others.size()); ++i)
+            {
+                if (i < preferred.size()) endpoints.push_back(preferred[i]);
+                if (i < others.size()) endpoints.push_back(others[i]);
+            }
+
+            return endpoints;
+        }
+
+        // Must be called from the executor given at construction
+        void start(std::optional<std::chrono::milliseconds> timeout, THandler handler)
+        {
+            m_handler = std::move(handler);
+
+            if (m_endpoints.empty()) return finish(m_lastError, nullptr);
+
+            if (timeout.has_value())
+            {
+                m_timeoutTimer.expires_after(timeout.value());
+                m_timeoutTimer.async_wait(boost::beast::bind_front_handler(&HappyEyeballs::onTimeout, shared_from_this()));
+            }
+
+            attempt();
+        }
+
+        // Must be called from the executor given at construction
+        void cancel()
+        {
+            abort(boost::asio::error::operation_aborted);
+        }
+
+    private:
+        void attempt()
+        {
+            m_attemptTimer.cancel();
+            if (m_done || m_next >= m_endpoints.size()) return;
+
+            auto index = m_next++;
+            m_sockets.push_back(std::make_unique<TSocket>(m_executor));
+            ++m_pending;
+            m_sockets.back()->async_connect(m_endpoints[index], boost::beast::bind_front_handler(&HappyEyeballs::onConnect, shared_from_this(), index));
+
+            if (m_next < m_endpoints.size())
+            {
+                m_attemptTimer.expires_after(m_attemptDelay);
+                m_attemptTimer.async_wait(boost::beast::bind_front_handler(&HappyEyeballs::onAttemptDelay, shared_from_this()));
+            }
+        }
+
+        void onAttemptDelay(const boost::beast::error_code& ec)
+        {
+            if (ec) return;
+            attempt();
+        }
+
+        void onConnect(std::size_t index, const boost::beast::error_code& ec)
+        {
+            --m_pending;
+            if (m_done) return;
+
+            if (!ec) return finish(ec, m_sockets[index].get(), index);
+
+            m_lastError = ec;
+
+            // A failed attempt immediately starts the next one
+            if (m_next < m_endpoints.size()) return attempt();
+
+            if (0 == m_pending) finish(m_lastError, nullptr);
+        }
+
+        void onTimeout(const boost::beast::error_code& ec)
+        {
+            if (ec) return;
+            abort(boost::beast::error::timeout);
+        }
+
+        void abort(const boost::beast::error_code& ec)
+        {
+            if (m_done) return;
+            finish(ec, nullptr);
+        }
+
+        void finish(const boost::beast::error_code& ec, TSocket* winner, std::size_t index = 0)
+        {
+            m_done = true;
+            m_attemptTimer.cancel();
+            m_timeoutTimer.cancel();
+
+            for (auto& socket : m_sockets)
+            {
+                boost::beast::error_code ignored;
+                if (socket.get() != winner) socket->close(ignored);
+            }
+
+            auto handler = std::move(m_handler);
+            if (nullptr != winner)
+            {
+                handler(ec, std::move(*winner), m_endpoints[index]);
+            }
+            else
+            {
+                TSocket none{ m_executor };
+                handler(ec, std::move(none), TEndpoint{});
+            }
+        }
+    };
+}
+
+#endif
@@ -5,12 +5,20 @@
 
 namespace Http::detail
 {
+    struct ISession;
+
+    using TResponseHandler = std::function<void(const Response&)>;
+    // Told of every session dispatched for a request, retries included
+    using TDispatchHook = std::function<void(const std::shared_ptr<ISession>&)>;
+
     struct ISession
     {
         virtual ~ISession() = default;
 
         virtual const boost::uuids::uuid& id() const = 0;
-        virtual void run(TRequestImplPtr req, std::promise<Response>& prom) = 0;
+        virtual const TRequestImplPtr& request() const = 0;
+        virtual bool headerReceived() const = 0;
+        virtual void run(TRequestImplPtr req, TResponseHandler handler, unsigned int attempt, TDispatchHook hook) = 0;
         virtual void cancel() = 0;
     };
 }
@@ -0,0 +1,69 @@
+#ifndef HTTP_LATENCY_TRACKER_HPP_INCLUDED
+#define HTTP_LATENCY_TRACKER_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+
+namespace Http::detail
+{
+    // Sliding window of the most recent latencies, used to learn percentiles
+    class LatencyTracker
+    {
+    private:
+        using TMutex = std::mutex;
+        using TLock = std::lock_guard<TMutex>;
+        using TSamples = std::vector<std::chrono::milliseconds>;
+
+        mutable TMutex m_mutex;
+        TSamples m_samples;
+        std::size_t m_next;
+
+    public:
+        static constexpr std::size_t WindowSize = 256;
+        static constexpr std::size_t MinSamples = 20;
+
+    public:
+        LatencyTracker()
+            : m_mutex{}
+            , m_samples{}
+            , m_next{ 0 }
+        {
+            m_samples.reserve(WindowSize);
+        }
+
+        virtual ~LatencyTracker() = default;
+        LatencyTracker(const LatencyTracker& other) = delete;
+        LatencyTracker& operator=(const LatencyTracker& other) = delete;
+        LatencyTracker(LatencyTracker&& other) = delete;
+        LatencyTracker& operator=(LatencyTracker&& other) = delete;
+
+        void record(std::chrono::milliseconds latency)
+        {
+            TLock lock{ m_mutex };
+            if (m_samples.size() < WindowSize)
+            {
+                m_samples.push_back(latency);
+            }
+            else
+            {
+                m_samples[m_next] = latency;
+                m_next = (m_next + 1) % WindowSize;
+            }
+        }
+
+        std::optional<std::chrono::milliseconds> percentile(double ratio) const
+        {
+            TSamples samples;
+            {
+                TLock lock{ m_mutex };
+                if (m_samples.size() < MinSamples) return std::nullopt;
+                samples = m_samples;
+            }
+
+            auto rank = static_cast<std::size_t>(std::clamp(ratio, 0.0, 1.0) * (samples.size() - 1));
+            std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+            return samples[rank];
+        }
+    };
+}
+
+#endif
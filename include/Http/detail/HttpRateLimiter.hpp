@@ -0,0 +1,80 @@
+#ifndef HTTP_RATE_LIMITER_HPP_INCLUDED
+#define HTTP_RATE_LIMITER_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+#include "Http/HttpOptions.hpp"
+#include "Http/detail/HttpTokenBucket.hpp"
+
+namespace Http::detail
+{
+    // Client-wide requests/sec and bytes/sec limits with a bounded number of delayed requests
+    class RateLimiter
+    {
+    private:
+        using TMutex = std::mutex;
+        using TLock = std::lock_guard<TMutex>;
+        using TTokenBucketPtr = std::unique_ptr<TokenBucket>;
+
+        TMutex m_mutex;
+        TTokenBucketPtr m_requests;
+        TTokenBucketPtr m_bytes;
+        std::size_t m_queued;
+        std::size_t m_maxQueued;
+
+    public:
+        RateLimiter(const Options& options)
+            : m_mutex{}
+            , m_requests{}
+            , m_bytes{}
+            , m_queued{ 0 }
+            , m_maxQueued{ options.maxQueuedRequests().value_or(Options::DefaultMaxQueuedRequests) }
+        {
+            if (options.maxRequestRate().has_value())
+            {
+                m_requests = std::make_unique<TokenBucket>(options.maxRequestRate().value(), options.maxRequestRate().value());
+            }
+
+            if (options.maxByteRate().has_value())
+            {
+                m_bytes = std::make_unique<TokenBucket>(options.maxByteRate().value(), options.maxByteRate().value());
+            }
+        }
+
+        virtual ~RateLimiter() = default;
+        RateLimiter(const RateLimiter& other) = delete;
+        RateLimiter& operator=(const RateLimiter& other) = delete;
+        RateLimiter(RateLimiter&& other) = delete;
+        RateLimiter& operator=(RateLimiter&& other) = delete;
+
+        bool enabled() const { return nullptr != m_requests || nullptr != m_bytes; }
+
+        // Returns how long the request must be delayed, or nothing when too many requests are already waiting
+        std::optional<std::chrono::nanoseconds> admit()
+        {
+            TLock lock{ m_mutex };
+
+            if (m_queued >= m_maxQueued) return std::nullopt;
+
+            auto delay = std::chrono::nanoseconds::zero();
+            if (nullptr != m_requests) delay = std::max(delay, m_requests->take(1.0));
+            if (nullptr != m_bytes) delay = std::max(delay, m_bytes->wait());
+
+            if (delay > std::chrono::nanoseconds::zero()) ++m_queued;
+            return delay;
+        }
+
+        void dequeue()
+        {
+            TLock lock{ m_mutex };
+            if (m_queued > 0) --m_queued;
+        }
+
+        // Bytes are charged once transferred; the resulting debt delays the next requests
+        void consume(std::size_t bytes)
+        {
+            if (nullptr != m_bytes) m_bytes->take(static_cast<double>(bytes));
+        }
+    };
+}
+
+#endif
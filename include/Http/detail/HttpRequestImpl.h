@@ -7,6 +7,8 @@
 #include "Http/HttpResponse.hpp"
 #include "Http/detail/empty_body.hpp"
 #include "Http/detail/basic_string_body.hpp"
+#include "Http/detail/basic_binary_body.hpp"
+#include "Http/detail/binary_view_body.hpp"
 #include "Http/detail/basic_file_body.hpp"
 #include "Http/detail/basic_multipart_body.hpp"
 
@@ -22,19 +24,29 @@ namespace Http::detail
 
         using Headers = std::map<std::string, std::string>;
 
-        std::string m_host;
-        std::string m_port;
         boost::beast::http::verb m_verb;
         std::string m_target;
         Options m_options;
         Headers m_headers;
         Body m_body;
-        TClientImplPtr m_clientImpl;
-        boost::uuids::uuid m_sessionId;
+        TClientImplWeakPtr m_clientImpl;
+        // The request this one was split from, whose cancel() reaches it too
+        const RequestImpl* m_origin;
+        // In-memory bodies are snapshotted (JSON ones dumped) once and shared by every attempt (retries, hedges),
+        // so that replacing the body never pulls the bytes from under a session still sending them
+        std::mutex m_snapshotMutex;
+        BinaryView m_snapshot;
+        // Prepared requests serialize their start line and frozen headers once per endpoint.
+        // The headers are guarded by m_headsMutex, since sends read them on the io threads
+        std::atomic<bool> m_prepared;
+        Headers m_frozenHeaders;
+        Headers m_variableHeaders;
+        std::mutex m_headsMutex;
+        std::map<std::string, std::shared_ptr<const std::string>> m_heads;
 
     public:
         RequestImpl() = delete;
-        RequestImpl(const std::string& host, const std::string& port, boost::beast::http::verb verb, const std::string& target, TClientImplPtr clientImpl);
+        RequestImpl(boost::beast::http::verb verb, const std::string& target, TClientImplPtr clientImpl);
         virtual ~RequestImpl() = default;
         RequestImpl(const RequestImpl& other) = delete;
         RequestImpl &operator=(const RequestImpl& other) = delete;
@@ -43,23 +55,44 @@ namespace Http::detail
 
         void header(const std::string& key, const std::string& value);
         void options(const Options& options);
+        void prepare();
+        bool prepared() const { return m_prepared; }
         const Options& options() const { return m_options; }
         const Body& body() { return m_body; }
         template <typename ContentType>
-        void body(ContentType&& content) { m_body = content; }
+        void body(ContentType&& content)
+        {
+            std::lock_guard<std::mutex> lock{ m_snapshotMutex };
+            m_body = std::forward<ContentType>(content);
+            m_snapshot = {};
+        }
 
         void cancel() const;
 
         std::string dump() const;
 
     private:
-        TEmptyRequest req0(const Options& options);
+        std::shared_ptr<RequestImpl> split();
+
+        template <typename SnapshotType>
+        BinaryView snapshot(SnapshotType&& take)
+        {
+            std::lock_guard<std::mutex> lock{ m_snapshotMutex };
+            if (false == m_snapshot.isShared()) m_snapshot = take();
+            return m_snapshot;
+        }
+
+        TEmptyRequest req0(const std::string& host, const Options& options, const TFieldsAllocator& allocator);
+        std::shared_ptr<const std::string> head(const std::string& host, const Options& options);
 
-        TEmptyRequestPtr prepare(const TEmpty& bodyContent, const Options& options, boost::beast::error_code& ec);
-        TStringRequestPtr prepare(const std::string& bodyContent, const Options& options, boost::beast::error_code& ec);
-        TStringRequestPtr prepare(const nlohmann::json& bodyContent, const Options& options, boost::beast::error_code& ec);
-        TFileRequestPtr prepare(const fs::path& bodyContent, const Options& options, boost::beast::error_code& ec);
-        TFormRequestPtr prepare(const FormData& bodyContent, const Options& options, boost::beast::error_code& ec);
+        TEmptyRequestPtr prepare(const TEmpty& bodyContent, const std::string& host, const Options& options, const TFieldsAllocator& allocator, boost::beast::error_code& ec);
+        TBinaryViewRequestPtr prepare(const std::string& bodyContent, const std::string& host, const Options& options, const TFieldsAllocator& allocator, boost::beast::error_code& ec);
+        TBinaryViewRequestPtr prepare(const nlohmann::json& bodyContent, const std::string& host, const Options& options, const TFieldsAllocator& allocator, boost::beast::error_code& ec);
+        TFileRequestPtr prepare(const fs::path& bodyContent, const std::string& host, const Options& options, const TFieldsAllocator& allocator, boost::beast::error_code& ec);
+        TFormRequestPtr prepare(const FormData& bodyContent, const std::string& host, const Options& options, const TFieldsAllocator& allocator, boost::beast::error_code& ec);
+        TBinaryViewRequestPtr prepare(const TBinary& bodyContent, const std::string& host, const Options& options, const TFieldsAllocator& allocator, boost::beast::error_code& ec);
+        TBinaryViewRequestPtr prepare(const BinaryView& bodyContent, const std::string& host, const Options& options, const TFieldsAllocator& allocator, boost::beast::error_code& ec);
+        TBinaryViewRequestPtr prepare(const LazyJson& bodyContent, const std::string& host, const Options& options, const TFieldsAllocator& allocator, boost::beast::error_code& ec);
 
         template <typename BodyType>
         void finalize(TRequestPtr<BodyType> &request)
@@ -9,41 +9,144 @@ namespace Http::detail
 {
     inline void RequestImpl::header(const std::string &key, const std::string &value)
     {
+        std::lock_guard<std::mutex> lock{ m_headsMutex };
         m_headers[key] = value;
+        if (false == m_prepared) return;
+
+        // Headers set once prepared are patched in on each send, a frozen one or a default moving over to them
+        m_variableHeaders[key] = value;
+        auto erased = std::size_t{ 0 };
+        for (auto it = m_frozenHeaders.begin(); it != m_frozenHeaders.end();)
+        {
+            if (boost::iequals(it->first, key))
+            {
+                it = m_frozenHeaders.erase(it);
+                ++erased;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        auto field = boost::beast::http::string_to_field(key);
+        if (0 != erased || boost::beast::http::field::host == field || boost::beast::http::field::user_agent == field || boost::beast::http::field::authorization == field)
+        {
+            m_heads.clear();
+        }
     }
 
     inline void RequestImpl::options(const Options& options)
     {
         m_options = options;
+
+        std::lock_guard<std::mutex> lock{ m_headsMutex };
+        m_heads.clear();
+    }
+
+    inline void RequestImpl::prepare()
+    {
+        std::lock_guard<std::mutex> lock{ m_headsMutex };
+        m_prepared = true;
+        m_frozenHeaders.clear();
+        m_variableHeaders.clear();
+        m_heads.clear();
+
+        // Headers the body sets stay variable, so that the body overrides them on each send
+        for (const auto &[key, value] : m_headers)
+        {
+            switch (boost::beast::http::string_to_field(key))
+            {
+            case boost::beast::http::field::content_type:
+            case boost::beast::http::field::content_length:
+            case boost::beast::http::field::transfer_encoding:
+                m_variableHeaders[key] = value;
+                break;
+            default:
+                m_frozenHeaders[key] = value;
+            }
+        }
     }
 
     inline void RequestImpl::cancel() const
     {
-        m_clientImpl->cancel(m_sessionId);
+        if (auto clientImpl = m_clientImpl.lock())
+        {
+            clientImpl->cancel(this);
+        }
     }
 
-    RequestImpl::RequestImpl(const std::string& host, const std::string& port, boost::beast::http::verb verb, const std::string &target, TClientImplPtr clientImpl)
-        : m_host{ host }
-        , m_port{ port }
-        , m_verb{ verb }
+    RequestImpl::RequestImpl(boost::beast::http::verb verb, const std::string &target, TClientImplPtr clientImpl)
+        : m_verb{ verb }
         , m_target{ target }
         , m_headers{}
         , m_body{}
         , m_clientImpl{ clientImpl }
+        , m_origin{ this }
+        , m_snapshotMutex{}
+        , m_snapshot{}
+        , m_prepared{ false }
+        , m_frozenHeaders{}
+        , m_variableHeaders{}
+        , m_headsMutex{}
+        , m_heads{}
     {}
 
-    inline TEmptyRequest RequestImpl::req0(const Options& options)
+    // Copies the request, so that a send split in several parts doesn't have them all serialize the same one
+    inline std::shared_ptr<RequestImpl> RequestImpl::split()
     {
-        TEmptyRequest req0{ m_verb, options.proxy().value_or("") + m_target, 11 };
-        req0.set(boost::beast::http::field::host, m_host + ":" + m_port);
-        req0.set(boost::beast::http::field::user_agent, BOOST_BEAST_VERSION_STRING);
+        auto part = std::make_shared<RequestImpl>(m_verb, m_target, m_clientImpl.lock());
+        part->m_origin = m_origin;
+        part->m_options = m_options;
+        {
+            std::lock_guard<std::mutex> lock{ m_snapshotMutex };
+            part->m_body = m_body;
+            part->m_snapshot = m_snapshot;
+        }
+        {
+            std::lock_guard<std::mutex> lock{ m_headsMutex };
+            part->m_headers = m_headers;
+            part->m_prepared = m_prepared.load();
+            part->m_frozenHeaders = m_frozenHeaders;
+            part->m_variableHeaders = m_variableHeaders;
+        }
+
+        return part;
+    }
+
+    inline TEmptyRequest RequestImpl::req0(const std::string& host, const Options& options, const TFieldsAllocator& allocator)
+    {
+        std::lock_guard<std::mutex> lock{ m_headsMutex };
+
+        TEmptyRequest req0{ std::piecewise_construct, std::make_tuple(), std::make_tuple(allocator) };
+        req0.method(m_verb);
+        req0.version(11);
 
-        if (true == options.auth().has_value())
+        // The start line and fixed headers of prepared requests come from their head
+        if (false == m_prepared)
         {
-            req0.set(boost::beast::http::field::authorization, options.auth().value());
+            req0.target(options.proxy().value_or("") + m_target);
+            req0.set(boost::beast::http::field::host, host);
+            req0.set(boost::beast::http::field::user_agent, BOOST_BEAST_VERSION_STRING);
+
+            if (true == options.auth().has_value())
+            {
+                req0.set(boost::beast::http::field::authorization, options.auth().value());
+            }
         }
 
-        for (const auto &[key, value] : m_headers)
+        if (true == options.range().has_value())
+        {
+            const auto& range = options.range().value();
+            req0.set(boost::beast::http::field::range, "bytes=" + std::to_string(range.first) + "-" + (range.last.has_value() ? std::to_string(range.last.value()) : std::string{}));
+        }
+
+        for (const auto &[key, value] : m_prepared ? m_variableHeaders : m_headers)
+        {
+            req0.set(key, value);
+        }
+
+        for (const auto &[key, value] : options.validators().value_or(Headers{}))
         {
             req0.set(key, value);
         }
@@ -51,41 +154,65 @@ namespace Http::detail
         return req0;
     }
 
-    inline TEmptyRequestPtr RequestImpl::prepare(const TEmpty&, const Options& options, boost::beast::error_code& ec)
+    inline std::shared_ptr<const std::string> RequestImpl::head(const std::string& host, const Options& options)
     {
-        ec = {};
-        return std::make_shared<TEmptyRequest>(req0(options));
+        std::lock_guard<std::mutex> lock{ m_headsMutex };
+        auto& head = m_heads[host];
+        if (nullptr != head) return head;
+
+        auto verb = boost::beast::http::to_string(m_verb);
+        std::string text;
+        text.reserve(256);
+        text.append(verb.data(), verb.size()).append(" ").append(options.proxy().value_or("")).append(m_target).append(" HTTP/1.1\r\n");
+
+        // User headers override the defaults, as they do for requests that aren't prepared
+        auto overridden = [this](boost::beast::http::field field)
+        {
+            auto matches = [field](const auto& header) { return boost::beast::http::string_to_field(header.first) == field; };
+            return std::any_of(m_frozenHeaders.begin(), m_frozenHeaders.end(), matches) || std::any_of(m_variableHeaders.begin(), m_variableHeaders.end(), matches);
+        };
+        if (false == overridden(boost::beast::http::field::host)) text.append("Host: ").append(host).append("\r\n");
+        if (false == overridden(boost::beast::http::field::user_agent)) text.append("User-Agent: ").append(BOOST_BEAST_VERSION_STRING).append("\r\n");
+        if (true == options.auth().has_value() && false == overridden(boost::beast::http::field::authorization)) text.append("Authorization: ").append(options.auth().value()).append("\r\n");
+
+        for (const auto &[key, value] : m_frozenHeaders)
+        {
+            text.append(key).append(": ").append(value).append("\r\n");
+        }
+
+        head = std::make_shared<const std::string>(std::move(text));
+        return head;
     }
 
-    inline TStringRequestPtr RequestImpl::prepare(const std::string& bodyContent, const Options& options, boost::beast::error_code& ec)
+    inline TEmptyRequestPtr RequestImpl::prepare(const TEmpty&, const std::string& host, const Options& options, const TFieldsAllocator& allocator, boost::beast::error_code& ec)
     {
         ec = {};
-        StringBody::value_type body{ bodyContent };
-        TStringRequestPtr request = std::make_shared<TStringRequest>(req0(options));
+        return allocateShared<TEmptyRequest>(allocator, req0(host, options, allocator));
+    }
+
+    inline TBinaryViewRequestPtr RequestImpl::prepare(const std::string& bodyContent, const std::string& host, const Options& options, const TFieldsAllocator& allocator, boost::beast::error_code& ec)
+    {
+        auto request = prepare(snapshot([&bodyContent]() { return BinaryView{ std::make_shared<const std::string>(bodyContent) }; }), host, options, allocator, ec);
         request->set(boost::beast::http::field::content_type, ContentApplicationText);
-        request->body() = std::move(body);
-        request->prepare_payload();
         return request;
     }
 
-    inline TStringRequestPtr RequestImpl::prepare(const nlohmann::json& bodyContent, const Options& options, boost::beast::error_code& ec)
+    inline TBinaryViewRequestPtr RequestImpl::prepare(const nlohmann::json& bodyContent, const std::string& host, const Options& options, const TFieldsAllocator& allocator, boost::beast::error_code& ec)
     {
-        ec = {};
-        StringBody::value_type body{ bodyContent.dump() };
-        TStringRequestPtr request = std::make_shared<TStringRequest>(req0(options));
+        auto request = prepare(snapshot([&bodyContent]() { return BinaryView{ std::make_shared<const std::string>(bodyContent.dump()) }; }), host, options, allocator, ec);
         request->set(boost::beast::http::field::content_type, ContentApplicationJson);
-        request->body() = std::move(body);
-        request->prepare_payload();
         return request;
     }
 
-    inline TFileRequestPtr RequestImpl::prepare(const fs::path& bodyContent, const Options& options, boost::beast::error_code& ec)
+    inline TFileRequestPtr RequestImpl::prepare(const fs::path& bodyContent, const std::string& host, const Options& options, const TFieldsAllocator& allocator, boost::beast::error_code& ec)
     {
         ec = {};
         FileBody::value_type body;
         body.open(bodyContent.string().c_str(), boost::beast::file_mode::scan, ec);
         if (ec) return nullptr;
-        TFileRequestPtr request = std::make_shared<TFileRequest>(req0(options));
+        // Falls back to reading the file when it can't be mapped
+        if (true == options.memoryMap().value_or(false)) body.map();
+        TFileRequestPtr request = allocateShared<TFileRequest>(allocator, req0(host, options, allocator));
         request->set(boost::beast::http::field::content_type, mime_type(bodyContent));
         request->body() = std::move(body);
         request->prepare_payload();
@@ -93,11 +220,11 @@ namespace Http::detail
         return request;
     }
 
-    inline TFormRequestPtr RequestImpl::prepare(const FormData& bodyContent, const Options& options, boost::beast::error_code& ec)
+    inline TFormRequestPtr RequestImpl::prepare(const FormData& bodyContent, const std::string& host, const Options& options, const TFieldsAllocator& allocator, boost::beast::error_code& ec)
     {
         ec = {};
         FormDataBody::value_type body{ bodyContent };
-        TFormRequestPtr request = std::make_shared<TFormRequest>(req0(options));
+        TFormRequestPtr request = allocateShared<TFormRequest>(allocator, req0(host, options, allocator));
         request->set(boost::beast::http::field::content_type, ContentMultipartFormData);
         request->body() = std::move(body);
         request->prepare_payload();
@@ -105,6 +232,30 @@ namespace Http::detail
         return request;
     }
 
+    inline TBinaryViewRequestPtr RequestImpl::prepare(const TBinary& bodyContent, const std::string& host, const Options& options, const TFieldsAllocator& allocator, boost::beast::error_code& ec)
+    {
+        return prepare(snapshot([&bodyContent]() { return BinaryView{ std::make_shared<const TBinary>(bodyContent) }; }), host, options, allocator, ec);
+    }
+
+    inline TBinaryViewRequestPtr RequestImpl::prepare(const BinaryView& bodyContent, const std::string& host, const Options& options, const TFieldsAllocator& allocator, boost::beast::error_code& ec)
+    {
+        ec = {};
+        TBinaryViewRequestPtr request = allocateShared<TBinaryViewRequest>(allocator, req0(host, options, allocator));
+        request->set(boost::beast::http::field::content_type, ContentApplicationOctetStream);
+        request->body() = bodyContent;
+        request->prepare_payload();
+
+        return request;
+    }
+
+    // A received JSON body is forwarded as is, without being parsed or dumped again
+    inline TBinaryViewRequestPtr RequestImpl::prepare(const LazyJson& bodyContent, const std::string& host, const Options& options, const TFieldsAllocator& allocator, boost::beast::error_code& ec)
+    {
+        auto request = prepare(snapshot([&bodyContent]() { return BinaryView{ bodyContent.shared() }; }), host, options, allocator, ec);
+        request->set(boost::beast::http::field::content_type, ContentApplicationJson);
+        return request;
+    }
+
     inline std::string RequestImpl::dump() const
     {
         //TODO add headers and synthetic body dump
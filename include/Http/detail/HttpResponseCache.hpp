@@ -0,0 +1,256 @@
+#ifndef HTTP_RESPONSE_CACHE_HPP_INCLUDED
+#define HTTP_RESPONSE_CACHE_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+#include "Http/HttpCache.hpp"
+#include "Http/HttpResponse.hpp"
+#include "Http/detail/HttpDate.hpp"
+
+namespace Http::detail
+{
+    // In-memory LRU of GET responses bounded by bytes, following the HTTP caching rules of a private cache
+    class ResponseCache
+    {
+    public:
+        using THeaders = std::map<std::string, std::string>;
+
+        struct Lookup
+        {
+            Response response;
+            bool fresh = false;
+        };
+
+    private:
+        using TMutex = std::mutex;
+        using TLock = std::lock_guard<TMutex>;
+        using TClock = std::chrono::system_clock;
+
+        struct Entry
+        {
+            std::string key;
+            Response response;
+            std::size_t size = 0;
+            TClock::time_point expires = {};
+            THeaders vary;
+        };
+
+        using TEntries = std::list<Entry>;
+
+        mutable TMutex m_mutex;
+        TEntries m_entries;
+        std::unordered_map<std::string, TEntries::iterator> m_index;
+        std::size_t m_capacity;
+        CacheStats m_stats;
+
+    public:
+        ResponseCache(std::size_t capacity)
+            : m_mutex{}
+            , m_entries{}
+            , m_index{}
+            , m_capacity{ capacity }
+            , m_stats{}
+        {}
+
+        virtual ~ResponseCache() = default;
+        ResponseCache(const ResponseCache& other) = delete;
+        ResponseCache& operator=(const ResponseCache& other) = delete;
+        ResponseCache(ResponseCache&& other) = delete;
+        ResponseCache& operator=(ResponseCache&& other) = delete;
+
+        CacheStats stats() const
+        {
+            TLock lock{ m_mutex };
+            return m_stats;
+        }
+
+        std::optional<Lookup> lookup(const std::string& key, const THeaders& requestHeaders)
+        {
+            TLock lock{ m_mutex };
+
+            auto it = m_index.find(key);
+            if (it == m_index.end() || false == matches(it->second->vary, requestHeaders)) return std::nullopt;
+
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+
+            Lookup result{ it->second->response, TClock::now() < it->second->expires };
+            if (result.fresh) ++m_stats.hits;
+            return result;
+        }
+
+        void store(const std::string& key, const THeaders& requestHeaders, const Response& response)
+        {
+            if (false == response.body().isEmpty() && false == response.body().isText() && false == response.body().isJson() && false == response.body().isBinary()) return;
+
+            TLock lock{ m_mutex };
+
+            ++m_stats.misses;
+            erase(key);
+
+            auto expires = expiry(response);
+            if (false == expires.has_value()) return;
+
+            auto size = bodySize(response.body()) + key.size();
+            for (const auto& [name, value] : response.headers()) size += name.size() + value.size();
+            if (size > m_capacity) return;
+
+            m_entries.push_front(Entry{ key, response, size, expires.value(), varyValues(response.header("vary"), requestHeaders) });
+            m_index[key] = m_entries.begin();
+            m_stats.bytes += size;
+            ++m_stats.entries;
+
+            while (m_stats.bytes > m_capacity) erase(m_entries.back().key);
+        }
+
+        // Refreshes an entry from a 304 answer and returns the stored response
+        std::optional<Response> revalidate(const std::string& key, const Response& notModified)
+        {
+            TLock lock{ m_mutex };
+
+            auto it = m_index.find(key);
+            if (it == m_index.end()) return std::nullopt;
+
+            auto& entry = *it->second;
+            for (const auto& [name, value] : notModified.headers())
+            {
+                if ("content-length" != name) entry.response.m_headers[name] = value;
+            }
+
+            auto expires = expiry(entry.response);
+            if (expires.has_value()) entry.expires = expires.value();
+
+            ++m_stats.revalidations;
+            return entry.response;
+        }
+
+        // Headers making a request conditional on the stored validators
+        static std::map<std::string, std::string> validators(const Response& response)
+        {
+            std::map<std::string, std::string> headers;
+            auto etag = response.header("etag");
+            auto lastModified = response.header("last-modified");
+            if (!etag.empty()) headers["If-None-Match"] = etag;
+            if (!lastModified.empty()) headers["If-Modified-Since"] = lastModified;
+            return headers;
+        }
+
+        // Values of the request headers named by a Vary header, which a stored response must be looked up with
+        static THeaders varyValues(const std::string& vary, const THeaders& requestHeaders)
+        {
+            THeaders values;
+            std::vector<std::string> names;
+            boost::algorithm::split(names, vary, boost::algorithm::is_any_of(","));
+            for (auto& name : names)
+            {
+                boost::algorithm::trim(name);
+                boost::algorithm::to_lower(name);
+                if (name.empty()) continue;
+
+                values[name] = {};
+                for (const auto& [key, value] : requestHeaders)
+                {
+                    if (boost::algorithm::iequals(key, name)) values[name] = value;
+                }
+            }
+
+            return values;
+        }
+
+        static bool matches(const THeaders& vary, const THeaders& requestHeaders)
+        {
+            std::string names;
+            for (const auto& [name, value] : vary) names += name + ",";
+            return varyValues(names, requestHeaders) == vary;
+        }
+
+        // Whether a response to an authorized request may be stored, see RFC 9111 section 3.5
+        static bool isPublic(const Response& response)
+        {
+            std::vector<std::string> directives;
+            auto cacheControl = boost::algorithm::to_lower_copy(response.header("cache-control"));
+            boost::algorithm::split(directives, cacheControl, boost::algorithm::is_any_of(","));
+            return std::any_of(directives.begin(), directives.end(), [](const auto& directive) { return "public" == boost::algorithm::trim_copy(directive); });
+        }
+
+        // Returns when the response stops being fresh, or nothing when it must not be stored
+        static std::optional<std::chrono::system_clock::time_point> expiry(const Response& response)
+        {
+            if (castFromEnum(boost::beast::http::status::ok) != response.status()) return std::nullopt;
+            if ("*" == response.header("vary")) return std::nullopt;
+
+            std::optional<std::chrono::seconds> maxAge;
+            bool noCache = false;
+
+            std::vector<std::string> directives;
+            auto cacheControl = boost::algorithm::to_lower_copy(response.header("cache-control"));
+            boost::algorithm::split(directives, cacheControl, boost::algorithm::is_any_of(","));
+            for (auto& directive : directives)
+            {
+                boost::algorithm::trim(directive);
+                if ("no-store" == directive) return std::nullopt;
+                if ("no-cache" == directive) noCache = true;
+                if (boost::algorithm::starts_with(directive, "max-age="))
+                {
+                    maxAge = std::chrono::seconds(std::strtoll(directive.c_str() + 8, nullptr, 10));
+                }
+            }
+
+            auto now = TClock::now();
+            auto date = parseHttpDate(response.header("date")).value_or(now);
+            auto lastModified = parseHttpDate(response.header("last-modified"));
+
+            TClock::duration lifetime = TClock::duration::zero();
+            if (true == noCache)
+            {
+                lifetime = TClock::duration::zero();
+            }
+            else if (maxAge.has_value())
+            {
+                lifetime = maxAge.value();
+            }
+            else if (!response.header("expires").empty())
+            {
+                auto expires = parseHttpDate(response.header("expires"));
+                if (expires.has_value()) lifetime = expires.value() - date;
+            }
+            else if (lastModified.has_value())
+            {
+                // Heuristic freshness: a tenth of the time since the last modification
+                lifetime = (date - lastModified.value()) / 10;
+            }
+
+            auto age = std::chrono::seconds(std::strtoll(response.header("age").c_str(), nullptr, 10));
+            auto expires = now + lifetime - age;
+
+            if (expires <= now && response.header("etag").empty() && false == lastModified.has_value()) return std::nullopt;
+
+            return expires;
+        }
+
+    private:
+        void erase(const std::string& key)
+        {
+            auto it = m_index.find(key);
+            if (it == m_index.end()) return;
+
+            m_stats.bytes -= it->second->size;
+            --m_stats.entries;
+            m_entries.erase(it->second);
+            m_index.erase(it);
+        }
+
+        static std::size_t bodySize(const Body& body)
+        {
+            auto visitor = overloaded{
+                [](const auto&) -> std::size_t { return 0; },
+                [](const std::string& text) -> std::size_t { return text.size(); },
+                [](const nlohmann::json& json) -> std::size_t { return json.dump().size(); },
+                [](const TBinary& binary) -> std::size_t { return binary.size(); },
+                [](const LazyJson& json) -> std::size_t { return json.raw().size(); }
+            };
+
+            return std::visit(visitor, body.content());
+        }
+    };
+}
+
+#endif
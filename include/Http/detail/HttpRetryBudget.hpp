@@ -0,0 +1,52 @@
+#ifndef HTTP_RETRY_BUDGET_HPP_INCLUDED
+#define HTTP_RETRY_BUDGET_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+
+namespace Http::detail
+{
+    // Client-wide token bucket bounding retries to a ratio of the original requests
+    class RetryBudget
+    {
+    private:
+        using TMutex = std::mutex;
+        using TLock = std::lock_guard<TMutex>;
+
+        TMutex m_mutex;
+        double m_ratio;
+        double m_balance;
+
+    public:
+        static constexpr double DefaultRatio = 0.2;
+        static constexpr double MaxBalance = 10.0;
+
+    public:
+        RetryBudget(double ratio = DefaultRatio)
+            : m_mutex{}
+            , m_ratio{ ratio }
+            , m_balance{ MaxBalance }
+        {}
+
+        virtual ~RetryBudget() = default;
+        RetryBudget(const RetryBudget& other) = delete;
+        RetryBudget& operator=(const RetryBudget& other) = delete;
+        RetryBudget(RetryBudget&& other) = delete;
+        RetryBudget& operator=(RetryBudget&& other) = delete;
+
+        void deposit()
+        {
+            TLock lock{ m_mutex };
+            m_balance = std::min(MaxBalance, m_balance + m_ratio);
+        }
+
+        bool withdraw()
+        {
+            TLock lock{ m_mutex };
+            if (m_balance < 1.0) return false;
+            m_balance -= 1.0;
+            return true;
+        }
+    };
+}
+
+#endif
@@ -6,6 +6,10 @@
 #include "Http/HttpResponse.hpp"
 #include "Http/HttpOptions.hpp"
 #include "Http/detail/HttpISession.hpp"
+#include "Http/detail/HttpEndpointPool.hpp"
+#include "Http/detail/HttpHappyEyeballs.hpp"
+#include "Http/detail/HttpTokenBucket.hpp"
+#include "Http/detail/HttpBufferPool.hpp"
 
 namespace Http::detail
 {
@@ -13,17 +17,35 @@ namespace Http::detail
     class SessionBase : public ISession
     {
     private:
+        using TStrand = boost::asio::strand<boost::asio::io_context::executor_type>;
+
         boost::uuids::uuid m_id;
         TClientImplWeakPtr m_clientImpl;
+        TArenaPtr m_arena;
         Options m_options;
         std::string m_host;
         std::string m_port;
+        std::string m_address;
+        std::size_t m_endpoint;
         std::string m_url;
+        TStrand m_strand;
         boost::asio::ip::tcp::resolver m_resolver;
-        boost::beast::flat_buffer m_buffer;
+        TFlatBuffer m_buffer;
+        boost::asio::steady_timer m_retryTimer;
+        boost::asio::steady_timer m_throttleTimer;
+        std::unique_ptr<TokenBucket> m_uploadPacer;
+        std::unique_ptr<TokenBucket> m_downloadPacer;
+        std::shared_ptr<HappyEyeballs> m_eyeballs;
         TRequestImplPtr m_request;
         Response m_response;
-        std::promise<Response> m_promise;
+        TResponseHandler m_handler;
+        TDispatchHook m_hook;
+        unsigned int m_attempt;
+        bool m_connected;
+        bool m_released;
+        std::atomic<bool> m_headerReceived;
+        std::chrono::steady_clock::time_point m_start;
+        std::size_t m_transferred;
         TProgressCb m_sendProgress;
         TProgressCb m_recvProgress;
         double m_sendStep;
@@ -34,11 +56,11 @@ namespace Http::detail
         std::size_t m_progressThreshold;
 
     protected:
-        bool m_cancel;
+        std::atomic<bool> m_cancel;
 
     public:
         SessionBase() = delete;
-        SessionBase(TClientImplPtr clientImpl, boost::asio::io_context& ioc, const std::string& host, const std::string& port, const Options& options);
+        SessionBase(TClientImplPtr clientImpl, boost::asio::io_context& ioc, const Endpoint& endpoint, std::size_t endpointIndex, const Options& options);
         virtual ~SessionBase() = default;
         SessionBase(const SessionBase &other) = delete;
         SessionBase &operator=(const SessionBase &other) = delete;
@@ -47,10 +69,14 @@ namespace Http::detail
 
 
         const boost::uuids::uuid& id() const override;
-        void run(TRequestImplPtr req, std::promise<Response>& prom) override;
+        const TRequestImplPtr& request() const override;
+        bool headerReceived() const override;
+        void run(TRequestImplPtr req, TResponseHandler handler, unsigned int attempt, TDispatchHook hook) override;
         void cancel() override;
 
     protected:
+        // Strand of the stream, shared by the resolver and the timers so that cancel() reaches them all at once
+        const TStrand& strand() const { return m_strand; }
         void handleError(const boost::beast::error_code& ec, const std::string& reason);
         void handleCancel();
         template <typename BodyType>
@@ -58,6 +84,7 @@ namespace Http::detail
         template <typename BodyType>
         void handleCancel(TResponseParserPtr<BodyType> parser);
         void writeRequest();
+        bool retry(std::optional<std::chrono::milliseconds> retryAfter);
 
     private:
         [[nodiscard]]
@@ -65,18 +92,37 @@ namespace Http::detail
 
         void onResolved(const boost::beast::error_code& ec, boost::asio::ip::tcp::resolver::results_type results);
         void onConnected(const boost::beast::error_code& ec, boost::asio::ip::tcp::resolver::results_type::endpoint_type);
+        void onRaced(const boost::beast::error_code& ec, HappyEyeballs::TSocket&& socket, const HappyEyeballs::TEndpoint& endpoint);
         void onWritten();
-        void onHeaderRead(TEmptyParserPtr parser0, const boost::beast::error_code& ec, std::size_t);
+        void onHeaderRead(TEmptyParserPtr parser0, const boost::beast::error_code& ec, std::size_t bytes_read);
         template <typename BodyType>
         void onBodyRead(TResponseParserPtr<BodyType> parser);
 
+        void onRetry(const boost::beast::error_code& ec);
+        void complete();
+        void release(std::optional<bool> success);
+
+        template <typename Handler>
+        void throttle(TokenBucket* pacer, TokenBucket* sharedPacer, std::size_t bytes, Handler&& next);
+
+        void shutdownStream();
         void closeStream();
 
+        template <typename BodyType>
+        void writeHead(TRequestPtr<BodyType> request, TRequestSerializerPtr<BodyType> serializer);
+
         template <typename BodyType>
         void onWriteSome(TRequestPtr<BodyType> request, TRequestSerializerPtr<BodyType> serializer, const boost::beast::error_code& ec, std::size_t bytes_written);
 
         template <typename BodyType>
         void onReadSome(TResponseParserPtr<BodyType> parser, const boost::beast::error_code& ec, std::size_t bytes_read);
+
+        template <typename BodyType>
+        static constexpr bool isInPlaceBody();
+        template <typename BodyType>
+        boost::asio::mutable_buffer bodyTarget(TResponseParserPtr<BodyType> parser);
+        template <typename BodyType>
+        void onReadInPlace(TResponseParserPtr<BodyType> parser, const boost::beast::error_code& ec, std::size_t bytes_read);
     };
 }
 
@@ -4,22 +4,39 @@
 #include "Http/detail/HttpSessionBase.h"
 #include "Http/detail/HttpRequestImpl.h"
 #include "Http/detail/empty_body.hpp"
+#include "Http/detail/HttpDate.hpp"
 
 namespace Http::detail
 {
     template <typename DerivedType>
-    inline SessionBase<DerivedType>::SessionBase(TClientImplPtr clientImpl, boost::asio::io_context& ioc, const std::string& host, const std::string& port, const Options& options)
+    inline SessionBase<DerivedType>::SessionBase(TClientImplPtr clientImpl, boost::asio::io_context& ioc, const Endpoint& endpoint, std::size_t endpointIndex, const Options& options)
         : m_id{ boost::uuids::random_generator()() }
         , m_clientImpl{ clientImpl }
-        , m_host{ host }
-        , m_port{ port }
-        , m_url{ host + ":" + port }
+        , m_arena{ std::make_shared<Arena>(nullptr != clientImpl ? clientImpl->arenaPool() : nullptr) }
+        , m_host{ endpoint.host }
+        , m_port{ endpoint.port }
+        , m_address{ endpoint.address }
+        , m_endpoint{ endpointIndex }
+        , m_url{ endpoint.host + ":" + endpoint.port }
         , m_options{ options }
-        , m_resolver{ boost::asio::make_strand(ioc) }
+        , m_strand{ boost::asio::make_strand(ioc) }
+        , m_resolver{ m_strand }
         , m_buffer{ Options::DefaultBufferSize }
+        , m_retryTimer{ m_strand }
+        , m_throttleTimer{ m_strand }
+        , m_uploadPacer{ TokenBucket::pacer(options.maxUploadRate()) }
+        , m_downloadPacer{ TokenBucket::pacer(options.maxDownloadRate()) }
+        , m_eyeballs{}
         , m_request{}
         , m_response{}
-        , m_promise{}
+        , m_handler{}
+        , m_hook{}
+        , m_attempt{ 0 }
+        , m_connected{ false }
+        , m_released{ false }
+        , m_headerReceived{ false }
+        , m_start{}
+        , m_transferred{ 0 }
         , m_cancel{ false }
     {
         static_assert(std::is_base_of_v<SessionBase<DerivedType>, DerivedType>);
@@ -33,6 +50,18 @@ namespace Http::detail
         return m_id;
     }
 
+    template <typename DerivedType>
+    inline const TRequestImplPtr& SessionBase<DerivedType>::request() const
+    {
+        return m_request;
+    }
+
+    template <typename DerivedType>
+    inline bool SessionBase<DerivedType>::headerReceived() const
+    {
+        return m_headerReceived;
+    }
+
     template <typename DerivedType>
     inline DerivedType& SessionBase<DerivedType>::derived()
     {
@@ -40,23 +69,35 @@ namespace Http::detail
     }
 
     template <typename DerivedType>
-    inline void SessionBase<DerivedType>::run(TRequestImplPtr req, std::promise<Response>& prom)
+    inline void SessionBase<DerivedType>::run(TRequestImplPtr req, TResponseHandler handler, unsigned int attempt, TDispatchHook hook)
     {
         m_request = req;
-        m_promise = std::move(prom);
+        m_handler = std::move(handler);
+        m_hook = std::move(hook);
+        m_attempt = attempt;
+        m_start = std::chrono::steady_clock::now();
 
         if (m_options.connectionTimeout().has_value())
         {
             boost::beast::get_lowest_layer(derived().stream()).expires_after(std::chrono::milliseconds(m_options.connectionTimeout().value()));
         }
 
-        m_resolver.async_resolve(m_host, m_port, boost::beast::bind_front_handler(&SessionBase::onResolved, derived().shared_from_this()));
+        m_resolver.async_resolve(m_address, m_port, boost::beast::bind_front_handler(&SessionBase::onResolved, derived().shared_from_this()));
     }
 
     template <typename DerivedType>
     inline void SessionBase<DerivedType>::cancel()
     {
         m_cancel = true;
+
+        auto self = derived().shared_from_this();
+        boost::asio::post(m_strand, [this, self] {
+            boost::beast::get_lowest_layer(derived().stream()).cancel();
+            if (nullptr != m_eyeballs) m_eyeballs->cancel();
+            m_resolver.cancel();
+            m_retryTimer.cancel();
+            m_throttleTimer.cancel();
+        });
     }
 
     template <typename DerivedType>
@@ -65,12 +106,18 @@ namespace Http::detail
         auto visitor = overloaded{
             [this](auto&& bodyContent) {
                 boost::beast::error_code ec;
-                auto request = m_request->prepare(bodyContent, m_options, ec);
+                auto request = m_request->prepare(bodyContent, m_url, m_options, TFieldsAllocator{ m_arena }, ec);
                 if (nullptr == request) return handleError(ec, "Failed to create request");
                 using TBodyType = typename decltype(request)::element_type::body_type;
-                auto serializer = std::make_shared<TRequestSerializer<TBodyType>>(*request);
+                auto serializer = allocateShared<TRequestSerializer<TBodyType>>(TFieldsAllocator{ m_arena }, *request);
                 if (m_options.readBufferSize().has_value()) serializer->writer_impl().buffer_size(m_options.readBufferSize().value());
 
+                // Keep each write within one pacing window when uploads are throttled
+                auto clientImpl = m_clientImpl.lock();
+                auto sharedPacer = nullptr != clientImpl ? clientImpl->uploadPacer() : nullptr;
+                if (nullptr != m_uploadPacer) serializer->limit(static_cast<std::size_t>(m_uploadPacer->burst()));
+                if (nullptr != sharedPacer) serializer->limit(std::min(serializer->limit(), static_cast<std::size_t>(sharedPacer->burst())));
+
                 if (m_options.sendProgress().has_value() && request->payload_size().has_value())
                 {
                     m_sendProgress = m_options.sendProgress().value();
@@ -81,6 +128,8 @@ namespace Http::detail
                     m_totalProcessed = 0;
                 }
 
+                if (m_request->prepared()) return writeHead(request, serializer);
+
                 onWriteSome(request, serializer, ec, 0);
             }
         };
@@ -88,13 +137,69 @@ namespace Http::detail
         std::visit(visitor, m_request->m_body.m_content);
     }
 
+    // Prepared requests send their head followed by the variable headers, the serializer only writing the body
+    template <typename DerivedType>
+    template <typename BodyType>
+    inline void SessionBase<DerivedType>::writeHead(TRequestPtr<BodyType> request, TRequestSerializerPtr<BodyType> serializer)
+    {
+        using TString = std::basic_string<char, std::char_traits<char>, TFieldsAllocator>;
+
+        auto head = m_request->head(m_url, m_options);
+        auto fields = allocateShared<TString>(TFieldsAllocator{ m_arena }, TFieldsAllocator{ m_arena });
+        for (const auto& field : *request)
+        {
+            fields->append(field.name_string().data(), field.name_string().size()).append(": ").append(field.value().data(), field.value().size()).append("\r\n");
+        }
+        fields->append("\r\n");
+
+        // The header formatted by the serializer is skipped
+        boost::beast::error_code ec;
+        serializer->split(true);
+        while (!ec && false == serializer->is_header_done())
+        {
+            serializer->next(ec, [&serializer](boost::beast::error_code&, const auto& buffers) { serializer->consume(boost::beast::buffer_bytes(buffers)); });
+        }
+        if (ec) return handleError(ec, "Failed to serialize request");
+
+        std::vector<boost::asio::const_buffer, ArenaAllocator<boost::asio::const_buffer>> buffers{ ArenaAllocator<boost::asio::const_buffer>{ m_arena } };
+        buffers.reserve(8);
+        buffers.push_back(boost::asio::buffer(*head));
+        buffers.push_back(boost::asio::buffer(*fields));
+
+        // At most a write buffer of the body joins the head in the same write, unless uploads are paced.
+        // Larger bodies (a whole mapped file slice) are left for onWriteSome to stream
+        std::size_t bodyBytes = 0;
+        if (false == serializer->is_done() && std::numeric_limits<std::size_t>::max() == serializer->limit())
+        {
+            auto limit = m_options.writeBufferSize().value_or(Options::DefaultBufferSize);
+            serializer->next(ec, [&buffers, &bodyBytes, limit](boost::beast::error_code&, const auto& body) {
+                auto prefix = boost::beast::buffers_prefix(limit, body);
+                for (auto buffer : boost::beast::buffers_range_ref(prefix)) buffers.push_back(buffer);
+                bodyBytes = boost::beast::buffer_bytes(prefix);
+            });
+            if (ec) return handleError(ec, "Failed to serialize request");
+        }
+
+        if (m_options.requestTimeout().has_value())
+        {
+            boost::beast::get_lowest_layer(derived().stream()).expires_after(std::chrono::milliseconds(m_options.requestTimeout().value()));
+        }
+
+        boost::asio::async_write(derived().stream(), buffers, [self = derived().shared_from_this(), request, serializer, head, fields, bodyBytes](const boost::beast::error_code& ec, std::size_t bytes_written) {
+            if (!ec) serializer->consume(bodyBytes);
+            self->onWriteSome(request, serializer, ec, bytes_written);
+        });
+    }
+
     template <typename DerivedType>
     template <typename BodyType>
     inline void SessionBase<DerivedType>::onWriteSome(TRequestPtr<BodyType> request, TRequestSerializerPtr<BodyType> serializer, const boost::beast::error_code& ec, std::size_t bytes_written)
     {
+        if (m_cancel) return handleCancel();
+
         if (ec) return handleError(ec, "Socket write failed");
 
-        if (m_cancel) return handleCancel();
+        m_transferred += bytes_written;
 
         if ((bool)m_sendProgress)
         {
@@ -109,12 +214,17 @@ namespace Http::detail
 
         if (!serializer->is_done())
         {
-            if (m_options.requestTimeout().has_value())
-            {
-                boost::beast::get_lowest_layer(derived().stream()).expires_after(std::chrono::milliseconds(m_options.requestTimeout().value()));
-            }
+            auto clientImpl = m_clientImpl.lock();
+            throttle(m_uploadPacer.get(), nullptr != clientImpl ? clientImpl->uploadPacer() : nullptr, bytes_written, [this, request, serializer](const boost::beast::error_code& ec) {
+                if (ec) return onWriteSome(request, serializer, ec, 0);
+
+                if (m_options.requestTimeout().has_value())
+                {
+                    boost::beast::get_lowest_layer(derived().stream()).expires_after(std::chrono::milliseconds(m_options.requestTimeout().value()));
+                }
 
-            boost::beast::http::async_write_some(derived().stream(), *serializer, boost::beast::bind_front_handler(&SessionBase::onWriteSome<BodyType>, derived().shared_from_this(), request, serializer));
+                boost::beast::http::async_write_some(derived().stream(), *serializer, boost::beast::bind_front_handler(&SessionBase::onWriteSome<BodyType>, derived().shared_from_this(), request, serializer));
+            });
         }
         else
         {
@@ -126,27 +236,65 @@ namespace Http::detail
     template <typename DerivedType>
     inline void SessionBase<DerivedType>::onResolved(const boost::beast::error_code& ec, boost::asio::ip::tcp::resolver::results_type results)
     {
+        if (m_cancel) return handleCancel();
+
         if (ec) return handleError(ec, "Failed to resolve " + m_url);
 
-        if (m_cancel) return handleCancel();
+        auto& stream = boost::beast::get_lowest_layer(derived().stream());
+
+        if (results.size() > 1 && m_options.happyEyeballs().value_or(true))
+        {
+            auto clientImpl = m_clientImpl.lock();
+            auto preferIpv6 = nullptr != clientImpl ? clientImpl->preferIpv6(m_address).value_or(true) : true;
+            auto endpoints = HappyEyeballs::interleave(results, preferIpv6);
+            auto delay = std::chrono::milliseconds(m_options.connectionAttemptDelay().value_or(Options::DefaultConnectionAttemptDelay));
+            std::optional<std::chrono::milliseconds> timeout;
+            if (m_options.connectionTimeout().has_value()) timeout = std::chrono::milliseconds(m_options.connectionTimeout().value());
+
+            boost::asio::post(stream.get_executor(), [this, self = derived().shared_from_this(), endpoints, delay, timeout] {
+                m_eyeballs = std::make_shared<HappyEyeballs>(boost::beast::get_lowest_layer(derived().stream()).get_executor(), endpoints, delay);
+                m_eyeballs->start(timeout, boost::beast::bind_front_handler(&SessionBase::onRaced, self));
+            });
+
+            return;
+        }
 
-        boost::beast::get_lowest_layer(derived().stream()).async_connect(results, boost::beast::bind_front_handler(&SessionBase::onConnected, derived().shared_from_this()));
+        stream.async_connect(results, boost::beast::bind_front_handler(&SessionBase::onConnected, derived().shared_from_this()));
     }
 
     template <typename DerivedType>
-    inline void SessionBase<DerivedType>::onConnected(const boost::beast::error_code& ec, boost::asio::ip::tcp::resolver::results_type::endpoint_type)
+    inline void SessionBase<DerivedType>::onRaced(const boost::beast::error_code& ec, HappyEyeballs::TSocket&& socket, const HappyEyeballs::TEndpoint& endpoint)
     {
-        if (ec) return handleError(ec, "Failed to connect to " + m_url);
+        m_eyeballs.reset();
+
+        if (!ec)
+        {
+            boost::beast::get_lowest_layer(derived().stream()).socket() = std::move(socket);
 
+            if (auto clientImpl = m_clientImpl.lock())
+            {
+                clientImpl->preferIpv6(m_address, endpoint.address().is_v6());
+            }
+        }
+
+        onConnected(ec, endpoint);
+    }
+
+    template <typename DerivedType>
+    inline void SessionBase<DerivedType>::onConnected(const boost::beast::error_code& ec, boost::asio::ip::tcp::resolver::results_type::endpoint_type)
+    {
         if (m_cancel) return handleCancel();
 
+        if (ec) return handleError(ec, "Failed to connect to " + m_url);
+
+        m_connected = true;
         derived().onConnected();
     }
 
     template <typename DerivedType>
     inline void SessionBase<DerivedType>::onWritten()
     {
-        auto parser0 = std::make_shared<TEmptyParser>();
+        auto parser0 = allocateShared<TEmptyParser>(TFieldsAllocator{ m_arena }, std::piecewise_construct, std::make_tuple(), std::make_tuple(TFieldsAllocator{ m_arena }));
 
         if (true == m_options.bodyLimit().has_value()) parser0->body_limit(m_options.bodyLimit().value());
 
@@ -159,13 +307,31 @@ namespace Http::detail
     }
 
     template <typename DerivedType>
-    inline void SessionBase<DerivedType>::onHeaderRead(TEmptyParserPtr parser0, const boost::beast::error_code& ec, std::size_t)
+    inline void SessionBase<DerivedType>::onHeaderRead(TEmptyParserPtr parser0, const boost::beast::error_code& ec, std::size_t bytes_read)
     {
+        if (m_cancel) return handleCancel();
+
         if (ec) return handleError(ec, "Socket read header failed");
 
-        if (m_cancel) return handleCancel();
+        m_transferred += bytes_read;
+
+        m_headerReceived = true;
+        if (auto clientImpl = m_clientImpl.lock())
+        {
+            clientImpl->headerLatency().record(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_start));
+        }
+
+        if (m_options.retryPolicy().has_value())
+        {
+            const auto& policy = m_options.retryPolicy().value();
+            const auto& header = parser0->get();
+            if (policy.isRetryable(header.result_int()) && policy.isRetryable(m_request->m_verb))
+            {
+                if (retry(parseHttpDelay(std::string{ header[boost::beast::http::field::retry_after] }))) return;
+            }
+        }
 
-        m_response.setContentType(*parser0);
+        m_response.setContentType(*parser0, m_options);
 
         auto visitor = overloaded{
             [this, parser0](auto&& bodyContent) {
@@ -184,7 +350,19 @@ namespace Http::detail
                     m_totalProcessed = 0;
                 }
 
-                onReadSome(parser, ec, 0);
+                // Bytes read along with the header are parsed now, which sizes the body for in place reads
+                std::size_t used = 0;
+                if constexpr (isInPlaceBody<TBodyType>())
+                {
+                    if (false == parser->is_done())
+                    {
+                        used = parser->put(m_buffer.data(), ec);
+                        m_buffer.consume(used);
+                        if (ec) return handleError(parser, ec, "Failed to parse body");
+                    }
+                }
+
+                onReadSome(parser, ec, used);
             }
         };
 
@@ -195,9 +373,11 @@ namespace Http::detail
     template <typename BodyType>
     inline void SessionBase<DerivedType>::onReadSome(TResponseParserPtr<BodyType> parser, const boost::beast::error_code& ec, std::size_t bytes_read)
     {
+        if (m_cancel) return handleCancel(parser);
+
         if (ec) return handleError(parser, ec, "Socket read failed");
 
-        if (m_cancel) return handleCancel(parser);
+        m_transferred += bytes_read;
 
         if ((bool)m_recvProgress)
         {
@@ -212,12 +392,26 @@ namespace Http::detail
 
         if (parser != nullptr && !parser->is_done())
         {
-            if (m_options.requestTimeout().has_value())
-            {
-                boost::beast::get_lowest_layer(derived().stream()).expires_after(std::chrono::milliseconds(m_options.requestTimeout().value()));
-            }
+            auto clientImpl = m_clientImpl.lock();
+            throttle(m_downloadPacer.get(), nullptr != clientImpl ? clientImpl->downloadPacer() : nullptr, bytes_read, [this, parser](const boost::beast::error_code& ec) {
+                if (ec) return onReadSome(parser, ec, 0);
+
+                if (m_options.requestTimeout().has_value())
+                {
+                    boost::beast::get_lowest_layer(derived().stream()).expires_after(std::chrono::milliseconds(m_options.requestTimeout().value()));
+                }
+
+                if constexpr (isInPlaceBody<BodyType>())
+                {
+                    auto target = bodyTarget(parser);
+                    if (0 != target.size())
+                    {
+                        return derived().stream().async_read_some(target, boost::beast::bind_front_handler(&SessionBase::onReadInPlace<BodyType>, derived().shared_from_this(), parser));
+                    }
+                }
 
-            boost::beast::http::async_read_some(derived().stream(), m_buffer, *parser, boost::beast::bind_front_handler(&SessionBase::onReadSome<BodyType>, derived().shared_from_this(), parser));
+                boost::beast::http::async_read_some(derived().stream(), m_buffer, *parser, boost::beast::bind_front_handler(&SessionBase::onReadSome<BodyType>, derived().shared_from_this(), parser));
+            });
         }
         else
         {
@@ -225,20 +419,159 @@ namespace Http::detail
         }
     }
 
+    template <typename DerivedType>
+    template <typename BodyType>
+    inline constexpr bool SessionBase<DerivedType>::isInPlaceBody()
+    {
+        return std::is_same_v<BodyType, StringBody> || std::is_same_v<BodyType, BinaryBody>;
+    }
+
+    // Remaining part of a body whose length is known, so that the socket reads straight into it
+    template <typename DerivedType>
+    template <typename BodyType>
+    inline boost::asio::mutable_buffer SessionBase<DerivedType>::bodyTarget(TResponseParserPtr<BodyType> parser)
+    {
+        auto remaining = parser->content_length_remaining();
+        if (0 != m_buffer.size() || false == remaining.has_value()) return {};
+
+        auto& body = parser->get().body();
+        auto offset = body.size() - static_cast<std::size_t>(remaining.value());
+        auto size = static_cast<std::size_t>(std::min<std::uint64_t>(remaining.value(), m_buffer.max_size()));
+
+        return { body.data() + offset, size };
+    }
+
+    template <typename DerivedType>
+    template <typename BodyType>
+    inline void SessionBase<DerivedType>::onReadInPlace(TResponseParserPtr<BodyType> parser, const boost::beast::error_code& ec, std::size_t bytes_read)
+    {
+        auto error = ec;
+        if (0 != bytes_read && false == parser->is_done())
+        {
+            // The reader recognizes the bytes as being in place and does not copy them
+            auto target = bodyTarget(parser);
+            boost::beast::error_code putError;
+            parser->put(boost::asio::const_buffer{ target.data(), bytes_read }, putError);
+            if (!error) error = putError;
+        }
+
+        onReadSome(parser, error, bytes_read);
+    }
+
     template <typename DerivedType>
     template <typename BodyType>
     inline void SessionBase<DerivedType>::onBodyRead(TResponseParserPtr<BodyType> parser)
     {
         closeStream();
         m_response.handleResponse(parser);
-        m_promise.set_value(m_response);
+        complete();
     }
 
     template <typename DerivedType>
-    inline void SessionBase<DerivedType>::closeStream()
+    inline bool SessionBase<DerivedType>::retry(std::optional<std::chrono::milliseconds> retryAfter)
+    {
+        if (false == m_options.retryPolicy().has_value()) return false;
+
+        const auto& policy = m_options.retryPolicy().value();
+        if (m_attempt + 1 >= policy.maxAttempts()) return false;
+
+        auto delay = policy.backoff(m_attempt);
+        if (retryAfter.has_value() && policy.honourRetryAfter())
+        {
+            if (retryAfter.value() > std::chrono::milliseconds(policy.maxDelay())) return false;
+            delay = std::max(delay, retryAfter.value());
+        }
+
+        auto clientImpl = m_clientImpl.lock();
+        if (nullptr == clientImpl || false == clientImpl->retryBudget().withdraw()) return false;
+
+        release(false);
+        shutdownStream();
+        m_retryTimer.expires_after(delay);
+        m_retryTimer.async_wait(boost::beast::bind_front_handler(&SessionBase::onRetry, derived().shared_from_this()));
+
+        return true;
+    }
+
+    template <typename DerivedType>
+    inline void SessionBase<DerivedType>::onRetry(const boost::beast::error_code& ec)
+    {
+        if (m_cancel) return handleCancel();
+
+        if (ec)
+        {
+            closeStream();
+            m_response.handleError(ec, "Retry aborted");
+            return complete();
+        }
+
+        auto clientImpl = m_clientImpl.lock();
+        if (nullptr == clientImpl)
+        {
+            closeStream();
+            m_response.handleError(boost::asio::error::operation_aborted, "Retry aborted, the client is gone");
+            return complete();
+        }
+
+        clientImpl->dispatch(m_request, std::move(m_handler), m_options, m_attempt + 1, m_hook);
+        clientImpl->clearSession(m_id);
+    }
+
+    template <typename DerivedType>
+    inline void SessionBase<DerivedType>::complete()
+    {
+        // Canceled and rate limited calls say nothing about the health of the endpoint
+        auto status = m_response.status();
+        if (StatusCanceled == status || StatusRateLimited == status) release(std::nullopt);
+        else release(castFromEnum(boost::beast::http::status::unknown) != status && status < 500);
+
+        // The read buffer goes back to the pool without waiting for the session to be released
+        m_buffer.clear();
+        m_buffer.shrink_to_fit();
+
+        if (m_handler) m_handler(m_response);
+    }
+
+    template <typename DerivedType>
+    inline void SessionBase<DerivedType>::release(std::optional<bool> success)
+    {
+        if (true == m_released) return;
+        m_released = true;
+
+        if (auto clientImpl = m_clientImpl.lock())
+        {
+            clientImpl->release(m_endpoint, success, std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_start));
+            clientImpl->rateLimiter().consume(m_transferred);
+        }
+    }
+
+    template <typename DerivedType>
+    template <typename Handler>
+    inline void SessionBase<DerivedType>::throttle(TokenBucket* pacer, TokenBucket* sharedPacer, std::size_t bytes, Handler&& next)
+    {
+        auto delay = std::chrono::nanoseconds::zero();
+        if (nullptr != pacer) delay = std::max(delay, pacer->take(static_cast<double>(bytes)));
+        if (nullptr != sharedPacer) delay = std::max(delay, sharedPacer->take(static_cast<double>(bytes)));
+
+        if (std::chrono::nanoseconds::zero() == delay) return next(boost::beast::error_code{});
+
+        m_throttleTimer.expires_after(delay);
+        m_throttleTimer.async_wait([this, self = derived().shared_from_this(), next = std::forward<Handler>(next)](const boost::beast::error_code& ec) {
+            next(m_cancel ? boost::asio::error::operation_aborted : ec);
+        });
+    }
+
+    template <typename DerivedType>
+    inline void SessionBase<DerivedType>::shutdownStream()
     {
         boost::beast::error_code ignored;
         boost::beast::get_lowest_layer(derived().stream()).socket().shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignored);
+    }
+
+    template <typename DerivedType>
+    inline void SessionBase<DerivedType>::closeStream()
+    {
+        shutdownStream();
 
         if (auto clientImpl = m_clientImpl.lock())
         {
@@ -251,7 +584,7 @@ namespace Http::detail
     {
         closeStream();
         m_response.handleCancel();
-        m_promise.set_value(m_response);
+        complete();
     }
 
     template <typename DerivedType>
@@ -260,15 +593,20 @@ namespace Http::detail
     {
         closeStream();
         m_response.handleCancel(parser);
-        m_promise.set_value(m_response);
+        complete();
     }
 
     template <typename DerivedType>
     inline void SessionBase<DerivedType>::handleError(const boost::beast::error_code& ec, const std::string& reason)
     {
+        if (false == m_connected && m_options.retryPolicy().has_value() && m_options.retryPolicy().value().retryOnConnectErrors())
+        {
+            if (retry({})) return;
+        }
+
         closeStream();
         m_response.handleError(ec, reason);
-        m_promise.set_value(m_response);
+        complete();
     }
 
     template <typename DerivedType>
@@ -277,7 +615,7 @@ namespace Http::detail
     {
         closeStream();
         m_response.handleError(parser, ec, reason);
-        m_promise.set_value(m_response);
+        complete();
     }
 }
 
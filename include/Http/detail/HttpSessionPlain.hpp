@@ -15,9 +15,9 @@ namespace Http::detail
 
     public:
         SessionPlain() = delete;
-        SessionPlain(TClientImplPtr clientImpl, boost::asio::io_context& ioc, const std::string& host, const std::string& port, const Options& options)
-            : SessionBase<SessionPlain>{ clientImpl, ioc, host, port, options }
-            , m_stream{ boost::asio::make_strand(ioc) }
+        SessionPlain(TClientImplPtr clientImpl, boost::asio::io_context& ioc, const Endpoint& endpoint, std::size_t endpointIndex, const Options& options)
+            : SessionBase<SessionPlain>{ clientImpl, ioc, endpoint, endpointIndex, options }
+            , m_stream{ strand() }
         {}
 
         virtual ~SessionPlain() = default;
@@ -16,10 +16,10 @@ namespace Http::detail
 
     public:
         SessionSsl() = delete;
-        SessionSsl(TClientImplPtr clientImpl, boost::asio::io_context& ioc, const std::string& host, const std::string& port, const Options& options)
-            : SessionBase<SessionSsl>{ clientImpl, ioc, host, port, options }
+        SessionSsl(TClientImplPtr clientImpl, boost::asio::io_context& ioc, const Endpoint& endpoint, std::size_t endpointIndex, const Options& options)
+            : SessionBase<SessionSsl>{ clientImpl, ioc, endpoint, endpointIndex, options }
             , m_ctx{ boost::asio::ssl::context::tlsv12_client }
-            , m_stream{ boost::asio::make_strand(ioc), m_ctx }
+            , m_stream{ strand(), m_ctx }
         {
             if (true == options.ca().has_value())
             {
@@ -44,10 +44,10 @@ namespace Http::detail
 
         void onHandshaked(const boost::beast::error_code& ec)
         {
-            if (ec) return handleError(ec, "Socket handshake failed");
-
             if (m_cancel) return handleCancel();
 
+            if (ec) return handleError(ec, "Socket handshake failed");
+
             writeRequest();
         }
     };
@@ -0,0 +1,75 @@
+#ifndef HTTP_SIMD_JSON_HPP_INCLUDED
+#define HTTP_SIMD_JSON_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+
+#if defined(HTTP_ENABLE_SIMDJSON)
+
+#include <simdjson.h>
+
+namespace Http::detail
+{
+    // Received bodies are allocated with this much slack so that simdjson parses them in place
+    static constexpr std::size_t JsonPadding = simdjson::SIMDJSON_PADDING;
+
+    inline nlohmann::json toJson(simdjson::dom::element element)
+    {
+        switch (element.type())
+        {
+        case simdjson::dom::element_type::ARRAY:
+        {
+            auto json = nlohmann::json::array();
+            for (auto child : element.get_array().value()) json.push_back(toJson(child));
+            return json;
+        }
+        case simdjson::dom::element_type::OBJECT:
+        {
+            auto json = nlohmann::json::object();
+            for (auto field : element.get_object().value()) json[std::string{ field.key }] = toJson(field.value);
+            return json;
+        }
+        case simdjson::dom::element_type::INT64:
+            return element.get_int64().value();
+        case simdjson::dom::element_type::UINT64:
+            return element.get_uint64().value();
+        case simdjson::dom::element_type::DOUBLE:
+            return element.get_double().value();
+        case simdjson::dom::element_type::STRING:
+            return std::string{ element.get_string().value() };
+        case simdjson::dom::element_type::BOOL:
+            return element.get_bool().value();
+        case simdjson::dom::element_type::NULL_VALUE:
+        default:
+            return nullptr;
+        }
+    }
+
+    // Parses with simdjson and builds the nlohmann document from the result, invalid JSON gives a null document
+    inline nlohmann::json parseJson(const std::string& raw)
+    {
+        static thread_local simdjson::dom::parser parser;
+
+        auto document = parser.parse(raw.data(), raw.size(), raw.capacity() < raw.size() + JsonPadding);
+        if (document.error()) return nullptr;
+
+        return toJson(document.value());
+    }
+}
+
+#else
+
+namespace Http::detail
+{
+    static constexpr std::size_t JsonPadding = 0;
+
+    inline nlohmann::json parseJson(const std::string& raw)
+    {
+        auto json = nlohmann::json::parse(raw, nullptr, false);
+        if (json.is_discarded()) return nullptr;
+        return json;
+    }
+}
+
+#endif
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef HTTP_TOKEN_BUCKET_HPP_INCLUDED
+#define HTTP_TOKEN_BUCKET_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+
+namespace Http::detail
+{
+    // Token bucket allowed to go into debt: callers take what they need and wait for the returned delay
+    class TokenBucket
+    {
+    private:
+        using TMutex = std::mutex;
+        using TLock = std::lock_guard<TMutex>;
+        using TClock = std::chrono::steady_clock;
+
+        TMutex m_mutex;
+        double m_rate;
+        double m_burst;
+        double m_tokens;
+        TClock::time_point m_last;
+
+    public:
+        static constexpr double PacingWindow = 0.1;
+
+    public:
+        TokenBucket(double rate, double burst)
+            : m_mutex{}
+            , m_rate{ rate }
+            , m_burst{ std::max(1.0, burst) }
+            , m_tokens{ m_burst }
+            , m_last{ TClock::now() }
+        {}
+
+        virtual ~TokenBucket() = default;
+        TokenBucket(const TokenBucket& other) = delete;
+        TokenBucket& operator=(const TokenBucket& other) = delete;
+        TokenBucket(TokenBucket&& other) = delete;
+        TokenBucket& operator=(TokenBucket&& other) = delete;
+
+        // Bucket holding at most PacingWindow seconds worth of tokens, so that transfers are spread evenly
+        static std::unique_ptr<TokenBucket> pacer(const std::optional<double>& rate)
+        {
+            if (false == rate.has_value()) return nullptr;
+            return std::make_unique<TokenBucket>(rate.value(), rate.value() * PacingWindow);
+        }
+
+        double rate() const { return m_rate; }
+        double burst() const { return m_burst; }
+
+        std::chrono::nanoseconds take(double tokens)
+        {
+            TLock lock{ m_mutex };
+            refill();
+            m_tokens -= tokens;
+            return debt();
+        }
+
+        // Time until the bucket is out of debt, without taking anything
+        std::chrono::nanoseconds wait()
+        {
+            TLock lock{ m_mutex };
+            refill();
+            return debt();
+        }
+
+    private:
+        void refill()
+        {
+            auto now = TClock::now();
+            std::chrono::duration<double> elapsed = now - m_last;
+            m_last = now;
+            m_tokens = std::min(m_burst, m_tokens + elapsed.count() * m_rate);
+        }
+
+        std::chrono::nanoseconds debt() const
+        {
+            if (m_tokens >= 0.0 || m_rate <= 0.0) return std::chrono::nanoseconds::zero();
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(-m_tokens / m_rate));
+        }
+    };
+}
+
+#endif
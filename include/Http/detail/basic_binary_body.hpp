@@ -0,0 +1,134 @@
+#ifndef BASIC_BINARY_BODY_HPP_INCLUDED
+#define BASIC_BINARY_BODY_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+#include "Http/detail/HttpArena.hpp"
+
+namespace Http::detail
+{
+    template <class ByteType>
+    struct basic_binary_body
+    {
+        using value_type = std::vector<ByteType>;
+
+        class reader
+        {
+        private:
+            value_type& m_body;
+            std::size_t m_size;
+
+        public:
+            template<bool isRequest, class Fields>
+            explicit reader(boost::beast::http::header<isRequest, Fields>&, value_type& body)
+                : m_body(body)
+                , m_size(0)
+            {
+            }
+
+            void init(boost::optional<uint64_t> const& length, boost::beast::error_code& ec)
+            {
+                m_size = m_body.size();
+                if (length)
+                {
+                    if (*length > m_body.max_size() - m_size)
+                    {
+                        ec = boost::beast::http::error::buffer_overflow;
+                        return;
+                    }
+
+                    // Sized up front so that the session can receive directly into it
+                    m_body.resize(m_size + boost::beast::detail::clamp(*length));
+                }
+
+                ec = {};
+            }
+
+            template<class ConstBufferSequence>
+            std::size_t put(ConstBufferSequence const& buffers, boost::beast::error_code& ec)
+            {
+                auto const extra = boost::beast::buffer_bytes(buffers);
+                ec = {};
+
+                // Unknown length (chunked): appended without zero-filling
+                if (extra > m_body.size() - m_size)
+                {
+                    if (extra > m_body.max_size() - m_size)
+                    {
+                        ec = boost::beast::http::error::buffer_overflow;
+                        return 0;
+                    }
+
+                    m_body.resize(m_size);
+                    for (auto b : boost::beast::buffers_range_ref(buffers))
+                    {
+                        auto first = static_cast<ByteType const*>(b.data());
+                        m_body.insert(m_body.end(), first, first + b.size());
+                    }
+                    m_size = m_body.size();
+
+                    return extra;
+                }
+
+                // Bytes received in place are already where they belong
+                auto dest = m_body.data() + m_size;
+                for (auto b : boost::beast::buffers_range_ref(buffers))
+                {
+                    if (static_cast<void const*>(dest) != b.data()) std::memcpy(dest, b.data(), b.size());
+                    dest += b.size();
+                }
+                m_size += extra;
+
+                return extra;
+            }
+
+            void finish(boost::beast::error_code& ec)
+            {
+                m_body.resize(m_size);
+                ec = {};
+            }
+        };
+
+        class writer
+        {
+            value_type const& m_body;
+
+        public:
+            using const_buffers_type = boost::asio::const_buffer;
+
+            template<bool isRequest, class Fields>
+            explicit writer(boost::beast::http::header<isRequest, Fields> const&, value_type const& b)
+                : m_body(b)
+            {
+            }
+
+            void buffer_size(std::size_t size)
+            {
+                //Not useful here
+            }
+
+            void init(boost::beast::error_code& ec)
+            {
+                ec = {};
+            }
+
+            boost::optional<std::pair<const_buffers_type, bool>> get(boost::beast::error_code& ec)
+            {
+                ec = {};
+                return { { const_buffers_type{ m_body.data(), m_body.size() }, false} };
+            }
+        };
+
+        static uint64_t size(value_type const& body)
+        {
+            return body.size();
+        }
+    };
+
+    using BinaryBody = basic_binary_body<std::byte>;
+    using TBinaryRequest = TRequest<BinaryBody>;
+    using TBinaryRequestPtr = TRequestPtr<BinaryBody>;
+    using TBinaryParser = TResponseParser<BinaryBody>;
+    using TBinaryParserPtr = std::shared_ptr<TBinaryParser>;
+}
+
+#endif
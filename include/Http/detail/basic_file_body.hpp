@@ -2,6 +2,8 @@
 #define BASIC_FILE_BODY_HPP_INCLUDED
 
 #include "Http/HttpForwards.hpp"
+#include "Http/detail/HttpArena.hpp"
+#include "Http/detail/HttpBufferPool.hpp"
 #include "Http/HttpOptions.hpp"
 
 namespace Http::detail
@@ -54,31 +56,32 @@ namespace Http::detail
         private:
             value_type& m_body;
             std::size_t m_remaining;
+            std::size_t m_offset;
             std::size_t m_read_buffer_size;
-            char* m_read_buffer;
+            PooledBuffer m_read_buffer;
 
         public:
             using const_buffers_type = boost::asio::const_buffer;
 
+            // Mapped bodies are handed out in large slices since they cost no copy
+            static constexpr std::size_t MappedChunkSize = 16_MiB;
+
             template<bool isRequest, class Fields>
             writer(boost::beast::http::header<isRequest, Fields>&, value_type& body)
                 : m_body{ body }
+                , m_offset{ 0 }
                 , m_read_buffer_size{ Options::DefaultBufferSize }
-                , m_read_buffer{ new char[Options::DefaultBufferSize] }
+                , m_read_buffer{}
             {
                 m_remaining = body.size();
             }
 
-            virtual ~writer()
-            {
-                delete[] m_read_buffer;
-            }
+            virtual ~writer() = default;
 
             void buffer_size(std::size_t size)
             {
-                delete[] m_read_buffer;
+                m_read_buffer.reset();
                 m_read_buffer_size = size;
-                m_read_buffer = new char[size];
             }
 
             void init(boost::beast::error_code& ec)
@@ -88,6 +91,8 @@ namespace Http::detail
 
             boost::optional<std::pair<const_buffers_type, bool>> get(boost::beast::error_code& ec)
             {
+                if (m_body.is_mapped()) return view(ec);
+
                 auto const amount = m_remaining > m_read_buffer_size ? m_read_buffer_size : m_remaining;
 
                 if (0 == amount)
@@ -96,7 +101,10 @@ namespace Http::detail
                     return boost::none;
                 }
 
-                auto const nbRead = m_body.read(m_read_buffer, amount, ec);
+                // Only borrowed for bodies read through the file
+                if (nullptr == m_read_buffer.data()) m_read_buffer = PooledBuffer{ m_read_buffer_size };
+
+                auto const nbRead = m_body.read(m_read_buffer.data(), amount, ec);
                 if (ec)
                 {
                     return boost::none;
@@ -111,7 +119,26 @@ namespace Http::detail
                 m_remaining -= nbRead;
 
                 ec = {};
-                return { { const_buffers_type{ m_read_buffer, nbRead }, m_remaining > 0 } };
+                return { { const_buffers_type{ m_read_buffer.data(), nbRead }, m_remaining > 0 } };
+            }
+
+        private:
+            boost::optional<std::pair<const_buffers_type, bool>> view(boost::beast::error_code& ec)
+            {
+                ec = {};
+                if (0 == m_remaining) return boost::none;
+
+                auto buffer = m_body.view(m_offset, std::min(m_remaining, MappedChunkSize));
+                if (0 == buffer.size())
+                {
+                    ec = boost::beast::http::error::short_read;
+                    return boost::none;
+                }
+
+                m_offset += buffer.size();
+                m_remaining -= buffer.size();
+
+                return { { buffer, m_remaining > 0 } };
             }
         };
 
@@ -2,7 +2,10 @@
 #define BASIC_MULTIPART_BODY_HPP_INCLUDED
 
 #include "Http/HttpForwards.hpp"
+#include "Http/detail/HttpArena.hpp"
+#include "Http/detail/HttpBufferPool.hpp"
 #include "Http/HttpOptions.hpp"
+#include "Http/detail/HttpAsyncFile.hpp"
 
 namespace Http::detail
 {
@@ -29,13 +32,18 @@ namespace Http::detail
         class writer
         {
         private:
+#if defined(HTTP_ENABLE_IO_URING)
+            using TFile = AsyncFile;
+#else
             using TFile = boost::beast::file;
+#endif
             enum class MultipartStep
             {
                 Parameters,
                 FileHeader,
                 FileData,
                 ClosingBoundary,
+                Done,
             };
             value_type &m_body;
             MultipartStep m_step = MultipartStep::Parameters;
@@ -44,32 +52,29 @@ namespace Http::detail
             unsigned int m_fileIndex{ 0 };
             unsigned long m_remainingBytes;
             std::size_t m_read_buffer_size;
-            char* m_read_buffer;
+            PooledBuffer m_read_buffer;
 
         public:
-            using const_buffers_type = boost::asio::const_buffer;
+            // Unused slots are left empty
+            using const_buffers_type = std::array<boost::asio::const_buffer, 4>;
 
             template <bool isRequest, class Fields>
             writer(boost::beast::http::header<isRequest, Fields> &header, value_type &body)
                 : m_body(body)
                 , m_read_buffer_size{ Options::DefaultBufferSize }
-                , m_read_buffer{ new char[Options::DefaultBufferSize] }
+                , m_read_buffer{}
             {
                 auto contentType = std::string{ header[boost::beast::http::field::content_type] } +"; " + m_body.m_multipart;
                 header.set(boost::beast::http::field::content_type, contentType);
                 m_remainingFiles = m_body.m_files.size();
             }
 
-            virtual ~writer()
-            {
-                delete[] m_read_buffer;
-            }
+            virtual ~writer() = default;
 
             void buffer_size(std::size_t size)
             {
-                delete[] m_read_buffer;
+                m_read_buffer.reset();
                 m_read_buffer_size = size;
-                m_read_buffer = new char[size];
             }
 
             void init(boost::beast::error_code &ec)
@@ -77,73 +82,95 @@ namespace Http::detail
                 ec = {};
             }
 
+            // Gathers the parameters, part headers, one file chunk and the closing boundary that follow each other,
+            // so that they go out in a single write
             boost::optional<std::pair<const_buffers_type, bool>> get(boost::beast::error_code &ec)
             {
-                switch (m_step)
-                {
-                case MultipartStep::Parameters:
-                {
-                    ec = {};
-                    if (0 == m_remainingFiles)
-                        m_step = MultipartStep::ClosingBoundary;
-                    else
-                        m_step = MultipartStep::FileHeader;
+                ec = {};
+                const_buffers_type buffers{};
+                std::size_t count = 0;
+                bool chunkRead = false;
 
-                    return { {const_buffers_type{ m_body.m_parameters.data(), m_body.m_parameters.size()}, true} };
-                }
-                case MultipartStep::FileHeader:
+                while (count < buffers.size())
                 {
-                    ec = {};
-                    m_file.open(m_body.m_files[m_fileIndex].m_path.string().c_str(), boost::beast::file_mode::read, ec);
-                    if (ec) return boost::none;
+                    switch (m_step)
+                    {
+                    case MultipartStep::Parameters:
+                    {
+                        if (0 == m_remainingFiles)
+                            m_step = MultipartStep::ClosingBoundary;
+                        else
+                            m_step = MultipartStep::FileHeader;
 
-                    m_file.seek(m_body.m_files[m_fileIndex].m_chunkOffset, ec);
-                    if (ec) return boost::none;
+                        buffers[count++] = boost::asio::const_buffer{ m_body.m_parameters.data(), m_body.m_parameters.size() };
+                        break;
+                    }
+                    case MultipartStep::FileHeader:
+                    {
+                        m_file.open(m_body.m_files[m_fileIndex].m_path.string().c_str(), boost::beast::file_mode::read, ec);
+                        if (ec) return boost::none;
 
-                    m_remainingBytes = m_body.m_files[m_fileIndex].m_chunkSize;
-                    m_step = MultipartStep::FileData;
+                        m_file.seek(m_body.m_files[m_fileIndex].m_chunkOffset, ec);
+                        if (ec) return boost::none;
 
-                    return { {const_buffers_type{ m_body.m_files[m_fileIndex].m_partHeader.data(), m_body.m_files[m_fileIndex].m_partHeader.size()}, true} };
-                }
-                case MultipartStep::FileData:
-                {
-                    auto const amount = m_remainingBytes > m_read_buffer_size ? m_read_buffer_size : static_cast<std::size_t>(m_remainingBytes); // Handle the case where the file is zero length
-                    if (amount == 0)
+                        m_remainingBytes = m_body.m_files[m_fileIndex].m_chunkSize;
+                        m_step = MultipartStep::FileData;
+
+                        buffers[count++] = boost::asio::const_buffer{ m_body.m_files[m_fileIndex].m_partHeader.data(), m_body.m_files[m_fileIndex].m_partHeader.size() };
+                        break;
+                    }
+                    case MultipartStep::FileData:
                     {
-                        ec = {};
+                        // The read buffer holds a single chunk until the buffers are consumed
+                        if (chunkRead) return { { buffers, true } };
+
+                        auto const amount = m_remainingBytes > m_read_buffer_size ? m_read_buffer_size : static_cast<std::size_t>(m_remainingBytes); // Handle the case where the file is zero length
+                        if (amount == 0)
+                        {
+                            nextFile();
+                            break;
+                        }
+                        if (nullptr == m_read_buffer.data()) m_read_buffer = PooledBuffer{ m_read_buffer_size };
+                        auto const nread = m_file.read(m_read_buffer.data(), amount, ec);
+                        if (ec)
+                        {
+                            boost::beast::error_code ignored;
+                            m_file.close(ignored);
+                            return boost::none;
+                        }
+                        if (nread == 0)
+                        {
+                            ec = boost::beast::http::error::short_read;
+                            return boost::none;
+                        }
+                        m_remainingBytes -= nread;
+                        chunkRead = true;
+
                         nextFile();
-                        return { {const_buffers_type{ m_read_buffer, 0}, true} };
+
+                        buffers[count++] = boost::asio::const_buffer{ m_read_buffer.data(), nread };
+                        break;
                     }
-                    auto const nread = m_file.read(m_read_buffer, amount, ec);
-                    if (ec)
+                    case MultipartStep::ClosingBoundary:
                     {
-                        boost::beast::error_code ignored;
-                        m_file.close(ignored);
-                        return boost::none;
+                        m_step = MultipartStep::Done;
+                        buffers[count++] = boost::asio::const_buffer{ m_body.m_closing.data(), m_body.m_closing.size() };
+                        return { { buffers, false } };
+                    }
+                    case MultipartStep::Done:
+                    {
+                        if (0 == count) return boost::none;
+                        return { { buffers, false } };
                     }
-                    if (nread == 0)
+                    default:
                     {
-                        ec = boost::beast::http::error::short_read;
+                        ec = boost::beast::http::error::unexpected_body;
                         return boost::none;
                     }
-                    m_remainingBytes -= nread;
-
-                    nextFile();
-
-                    ec = {};
-                    return { {const_buffers_type{ m_read_buffer, nread}, true} };
-                }
-                case MultipartStep::ClosingBoundary:
-                {
-                    ec = {};
-                    return { {const_buffers_type{ m_body.m_closing.data(), m_body.m_closing.size()}, false} };
-                }
-                default:
-                {
-                    ec = boost::beast::http::error::unexpected_body;
-                    return boost::none;
-                }
+                    }
                 }
+
+                return { { buffers, true } };
             }
 
         private:
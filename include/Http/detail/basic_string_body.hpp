@@ -2,6 +2,8 @@
 #define BASIC_STRING_BODY_HPP_INCLUDED
 
 #include "Http/HttpForwards.hpp"
+#include "Http/detail/HttpArena.hpp"
+#include "Http/detail/HttpSimdJson.hpp"
 
 namespace Http::detail
 {
@@ -15,25 +17,31 @@ namespace Http::detail
         {
         private:
             value_type& m_body;
+            std::size_t m_size;
 
         public:
             template<bool isRequest, class Fields>
             explicit reader(boost::beast::http::header<isRequest, Fields>&, value_type& body)
                 : m_body(body)
+                , m_size(0)
             {
             }
 
             void init(boost::optional<uint64_t> const& length, boost::beast::error_code& ec)
             {
+                m_size = m_body.size();
                 if (length)
                 {
-                    if(*length > m_body.max_size())
+                    if(*length > m_body.max_size() - m_size)
                     {
                         ec = boost::beast::http::error::buffer_overflow;
                         return;
                     }
 
-                    m_body.reserve(boost::beast::detail::clamp(*length));
+                    // Room for the JSON parser padding, so that the body is never copied to be parsed.
+                    // The body is sized up front so that the session can receive directly into it
+                    m_body.reserve(boost::beast::detail::clamp(m_size + *length + JsonPadding));
+                    m_body.resize(m_size + boost::beast::detail::clamp(*length));
                 }
 
                 ec = {};
@@ -43,27 +51,42 @@ namespace Http::detail
             std::size_t put(ConstBufferSequence const& buffers, boost::beast::error_code& ec)
             {
                 auto const extra = boost::beast::buffer_bytes(buffers);
-                auto const size = m_body.size();
-                if (extra > m_body.max_size() - size)
+                ec = {};
+
+                // Unknown length (chunked): appended without zero-filling
+                if (extra > m_body.size() - m_size)
                 {
-                    ec = boost::beast::http::error::buffer_overflow;
-                    return 0;
+                    if (extra > m_body.max_size() - m_size)
+                    {
+                        ec = boost::beast::http::error::buffer_overflow;
+                        return 0;
+                    }
+
+                    m_body.resize(m_size);
+                    for (auto b : boost::beast::buffers_range_ref(buffers))
+                    {
+                        m_body.append(static_cast<CharType const*>(b.data()), b.size());
+                    }
+                    m_size = m_body.size();
+
+                    return extra;
                 }
 
-                m_body.resize(size + extra);
-                ec = {};
-                CharType* dest = &m_body[size];
+                // Bytes received in place are already where they belong
+                CharType* dest = &m_body[m_size];
                 for (auto b : boost::beast::buffers_range_ref(buffers))
                 {
-                    Traits::copy(dest, static_cast<CharType const*>(b.data()), b.size());
+                    if (static_cast<void const*>(dest) != b.data()) Traits::copy(dest, static_cast<CharType const*>(b.data()), b.size());
                     dest += b.size();
                 }
+                m_size += extra;
 
                 return extra;
             }
 
             void finish(boost::beast::error_code& ec)
             {
+                m_body.resize(m_size);
                 ec = {};
             }
         };
@@ -0,0 +1,55 @@
+#ifndef BINARY_VIEW_BODY_HPP_INCLUDED
+#define BINARY_VIEW_BODY_HPP_INCLUDED
+
+#include "Http/HttpForwards.hpp"
+#include "Http/detail/HttpArena.hpp"
+#include "Http/HttpBinaryView.hpp"
+
+namespace Http::detail
+{
+    // Serializes bytes owned elsewhere as a single const buffer, requests only
+    struct binary_view_body
+    {
+        using value_type = BinaryView;
+
+        struct writer
+        {
+            value_type const& m_body;
+
+            using const_buffers_type = boost::asio::const_buffer;
+
+            template<bool isRequest, class Fields>
+            explicit writer(boost::beast::http::header<isRequest, Fields> const&, value_type const& body)
+                : m_body(body)
+            {
+            }
+
+            void buffer_size(std::size_t size)
+            {
+                //Not useful here
+            }
+
+            void init(boost::beast::error_code& ec)
+            {
+                ec = {};
+            }
+
+            boost::optional<std::pair<const_buffers_type, bool>> get(boost::beast::error_code& ec)
+            {
+                ec = {};
+                return { { const_buffers_type{ m_body.data(), m_body.size() }, false } };
+            }
+        };
+
+        static uint64_t size(value_type const& body)
+        {
+            return body.size();
+        }
+    };
+
+    using BinaryViewBody = binary_view_body;
+    using TBinaryViewRequest = TRequest<BinaryViewBody>;
+    using TBinaryViewRequestPtr = TRequestPtr<BinaryViewBody>;
+}
+
+#endif
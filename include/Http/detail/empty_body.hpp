@@ -2,6 +2,7 @@
 #define EMPTY_BODY_HPP_INCLUDED
 
 #include "Http/HttpForwards.hpp"
+#include "Http/detail/HttpArena.hpp"
 
 namespace Http::detail
 {
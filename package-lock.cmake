@@ -77,3 +77,13 @@ CPMDeclarePackage(googletest
     "gtest_force_shared_crt"
     "ECLUDE_FROM_ALL True"
 )
+
+# simdjson
+CPMDeclarePackage(simdjson
+  NAME simdjson
+  VERSION 3.10.1
+  GITHUB_REPOSITORY simdjson/simdjson
+  OPTIONS
+    "SIMDJSON_DEVELOPER_MODE OFF"
+  EXCLUDE_FROM_ALL True
+)
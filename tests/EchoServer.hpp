@@ -2,11 +2,16 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/connect.hpp>
 #include <boost/config.hpp>
+#include <atomic>
+#include <condition_variable>
 #include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <thread>
+#include <vector>
 #include <chrono>
 
 namespace beast = boost::beast;   // from <boost/beast.hpp>
@@ -47,6 +52,103 @@ private:
       req.target()[0] != '/' ||
       req.target().find("..") != beast::string_view::npos)
       return send(bad_request("Illegal request-target"));
+
+    // Simulate a slow upstream if requested
+    if (auto delay = nextDelay())
+      std::this_thread::sleep_for(*delay);
+
+    // Simulate a failing upstream if requested
+    if (auto failure = nextFailure())
+    {
+      http::response<http::empty_body> res{failure->first, req.version()};
+      res.set(http::field::server, BOOST_BEAST_VERSION_STRING);
+      if (!failure->second.empty())
+        res.set(http::field::retry_after, failure->second);
+      res.content_length(0);
+      res.keep_alive(req.keep_alive());
+      return send(std::move(res));
+    }
+
+    // Serve a cacheable resource, revalidated through its ETag
+    if (req.target().starts_with("/cached"))
+    {
+      auto const target = std::string(req.target());
+      auto const query = target.find("max-age=");
+      auto const maxAge = query == std::string::npos ? std::string("60") : target.substr(query + 8);
+      auto const cacheControl = (target.find("public") == std::string::npos ? std::string() : std::string("public, ")) + "max-age=" + maxAge;
+      if (req[http::field::if_none_match] == "\"v1\"")
+      {
+        http::response<http::empty_body> res{http::status::not_modified, req.version()};
+        res.set(http::field::server, BOOST_BEAST_VERSION_STRING);
+        res.set(http::field::etag, "\"v1\"");
+        res.set(http::field::cache_control, cacheControl);
+        res.keep_alive(req.keep_alive());
+        return send(std::move(res));
+      }
+      http::response<http::string_body> res{http::status::ok, req.version()};
+      res.set(http::field::server, BOOST_BEAST_VERSION_STRING);
+      res.set(http::field::content_type, target.find("binary") == std::string::npos ? "application/text" : "application/octet-stream");
+      res.set(http::field::etag, "\"v1\"");
+      res.set(http::field::cache_control, cacheControl);
+      if (target.find("vary") != std::string::npos) res.set(http::field::vary, "Accept-Language");
+      if (target.find("cookies") != std::string::npos)
+      {
+        res.insert(http::field::set_cookie, "a=1; Expires=Wed, 21 Oct 2026 07:28:00 GMT");
+        res.insert(http::field::set_cookie, "b=2");
+      }
+      res.body() = "cached";
+      res.prepare_payload();
+      res.keep_alive(req.keep_alive());
+      return send(std::move(res));
+    }
+
+    // Echo the request header lines, one per line
+    if (req.target() == "/headers")
+    {
+      http::response<http::string_body> res{http::status::ok, req.version()};
+      res.set(http::field::server, BOOST_BEAST_VERSION_STRING);
+      res.set(http::field::content_type, "application/text");
+      for (auto const& field : req)
+        res.body() += std::string(field.name_string()) + ": " + std::string(field.value()) + "\n";
+      res.prepare_payload();
+      res.keep_alive(req.keep_alive());
+      return send(std::move(res));
+    }
+
+    // Serve a binary resource honouring single byte ranges
+    if (req.target() == "/file")
+    {
+      auto const content = fileContent();
+      auto first = std::size_t{0};
+      auto last = content.size() - 1;
+      auto const range = std::string(req[http::field::range]);
+      if (!range.empty())
+      {
+        auto const dash = range.find('-');
+        first = std::stoul(range.substr(6, dash - 6));
+        if (dash + 1 < range.size())
+          last = std::min(last, std::stoul(range.substr(dash + 1)));
+      }
+      if (first >= content.size())
+      {
+        http::response<http::empty_body> res{http::status::range_not_satisfiable, req.version()};
+        res.set(http::field::content_range, "bytes */" + std::to_string(content.size()));
+        res.content_length(0);
+        res.keep_alive(req.keep_alive());
+        return send(std::move(res));
+      }
+      http::response<http::string_body> res{range.empty() ? http::status::ok : http::status::partial_content, req.version()};
+      res.set(http::field::server, BOOST_BEAST_VERSION_STRING);
+      res.set(http::field::content_type, "application/octet-stream");
+      res.set(http::field::accept_ranges, "bytes");
+      if (!range.empty())
+        res.set(http::field::content_range, "bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" + std::to_string(content.size()));
+      res.body() = content.substr(first, last - first + 1);
+      res.prepare_payload();
+      res.keep_alive(req.keep_alive());
+      return send(std::move(res));
+    }
+
     // Cache the size since we need it after the move
     auto const size = req.body().size();
 
@@ -65,7 +167,8 @@ private:
       if (contentType == "text" ||
         contentType == "application/text" ||
         contentType == "application/json" ||
-        contentType == "application/xml"
+        contentType == "application/xml" ||
+        contentType == "application/octet-stream"
       )
       {
         http::string_body::value_type body = req.body();
@@ -174,40 +277,147 @@ private:
     // At this point the connection is closed gracefully
   }
 
+  // Returns the status to answer with if a failure is pending
+  std::optional<std::pair<http::status, std::string>> nextFailure()
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    if (failures == 0)
+      return std::nullopt;
+    if (failuresAfter > 0)
+    {
+      --failuresAfter;
+      return std::nullopt;
+    }
+    --failures;
+    return std::make_pair(failureStatus, failureRetryAfter);
+  }
+
+  // Returns the delay to wait before answering if one is pending
+  std::optional<std::chrono::milliseconds> nextDelay()
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    if (delays == 0)
+      return std::nullopt;
+    --delays;
+    changed.notify_all();
+    return delay;
+  }
+
+  // Accepts connections until stopped, each one served on its own thread
+  void do_accept()
+  {
+    acceptor->async_accept(
+      [this](beast::error_code ec, tcp::socket socket) {
+        if (ec)
+          return;
+
+        ++connections;
+        {
+          std::lock_guard<std::mutex> lock{mutex};
+          ++active;
+          sessions.emplace_back([this, socket = std::move(socket)]() mutable {
+            do_session(std::move(socket));
+            std::lock_guard<std::mutex> lock{mutex};
+            --active;
+            changed.notify_all();
+          });
+        }
+        do_accept();
+      });
+  }
+
   net::io_context ioc;
+  std::unique_ptr<tcp::acceptor> acceptor;
   std::unique_ptr<std::thread> thread;
+  std::vector<std::thread> sessions;
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::size_t active = 0;
+  std::size_t failures = 0;
+  std::size_t failuresAfter = 0;
+  http::status failureStatus = http::status::ok;
+  std::string failureRetryAfter;
+  std::size_t delays = 0;
+  std::chrono::milliseconds delay{0};
+  std::atomic<std::size_t> connections{0};
 
 public:
   EchoServer() : ioc{1}, thread{nullptr} {}
 
   void start()
   {
-    thread = std::make_unique<std::thread>(
-      [this]{
-        // The io_context is required for all I/O
-        const auto address = net::ip::make_address("0.0.0.0");
-        const auto port = 8281;
-        tcp::endpoint ep{address, port};
-        // The acceptor receives incoming connections
-        tcp::acceptor acceptor{ioc, ep};
-
-        // This will receive the new connection
-        tcp::socket socket{ioc};
-
-        // Block until we get a connection
-        acceptor.accept(socket);
-
-        // Launch the session, transferring ownership of the socket
-        do_session(std::move(socket));
-      }
-    );
+    // The io_context is required for all I/O
+    const auto address = net::ip::make_address("0.0.0.0");
+    const auto port = 8281;
+    tcp::endpoint ep{address, port};
+    // The acceptor receives incoming connections
+    acceptor = std::make_unique<tcp::acceptor>(ioc, ep);
+
+    do_accept();
+
+    thread = std::make_unique<std::thread>([this]{ ioc.run(); });
 
     std::this_thread::sleep_for(100ms);
   }
 
   void stop()
   {
+    net::post(ioc, [this]{ acceptor->close(); });
     thread->join();
     thread.release();
+
+    std::vector<std::thread> finished;
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      finished.swap(sessions);
+    }
+    for (auto& session : finished)
+      session.join();
+  }
+
+  // Answers the next `count` requests with `status` instead of echoing them
+  void failNext(std::size_t count, http::status status, const std::string& retryAfter = {}, std::size_t after = 0)
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    failures = count;
+    failuresAfter = after;
+    failureStatus = status;
+    failureRetryAfter = retryAfter;
+  }
+
+  // Waits `duration` before answering the next `count` requests
+  void delayNext(std::size_t count, std::chrono::milliseconds duration)
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    delays = count;
+    delay = duration;
+  }
+
+  // Blocks until the delayed requests have all been received
+  void waitDelayed()
+  {
+    std::unique_lock<std::mutex> lock{mutex};
+    changed.wait(lock, [this]{ return delays == 0; });
+  }
+
+  // Blocks until every connection has been served and closed
+  void waitIdle()
+  {
+    std::unique_lock<std::mutex> lock{mutex};
+    changed.wait(lock, [this]{ return active == 0; });
+  }
+
+  // Content of the "/file" resource
+  static std::string fileContent()
+  {
+    std::string content;
+    for (auto i = 0; i < 10000; ++i)
+      content += std::to_string(1000000 + i);
+    return content;
+  }
+
+  std::size_t nbConnections() const
+  {
+    return connections;
   }
 };
@@ -124,3 +124,735 @@ TEST_F(HttpFixture, test_delete_struct)
   auto content = res.body().get<Person>();
   ASSERT_EQ(content, person);
 }
+
+TEST_F(HttpFixture, test_retry_on_unavailable)
+{
+  server->failNext(2, http::status::service_unavailable, "0");
+  auto options = Http::Options{}.retryPolicy(Http::RetryPolicy{}.maxAttempts(3).baseDelay(10));
+  auto res = client->get("/").options(options).send().get();
+  ASSERT_TRUE(res.ok());
+  ASSERT_EQ(server->nbConnections(), 3u);
+}
+
+TEST_F(HttpFixture, test_retry_exhausted)
+{
+  server->failNext(3, http::status::bad_gateway);
+  auto options = Http::Options{}.retryPolicy(Http::RetryPolicy{}.maxAttempts(2).baseDelay(10));
+  auto res = client->get("/").options(options).send().get();
+  ASSERT_EQ(res.status(), 502u);
+  ASSERT_EQ(server->nbConnections(), 2u);
+}
+
+TEST_F(HttpFixture, test_no_retry_non_idempotent)
+{
+  server->failNext(1, http::status::service_unavailable);
+  Person body{"captain", 42};
+  auto options = Http::Options{}.retryPolicy(Http::RetryPolicy{}.baseDelay(10));
+  auto res = client->post("/").body(body).options(options).send().get();
+  ASSERT_EQ(res.status(), 503u);
+  ASSERT_EQ(server->nbConnections(), 1u);
+}
+
+TEST_F(HttpFixture, test_retry_on_connect_error)
+{
+  Http::Client unreachable{"http://127.0.0.1:8282"};
+  auto options = Http::Options{}.retryPolicy(Http::RetryPolicy{}.maxAttempts(2).baseDelay(10));
+  auto res = unreachable.get("/").options(options).send().get();
+  ASSERT_FALSE(res.ok());
+}
+
+TEST_F(HttpFixture, test_hedged_get)
+{
+  server->delayNext(1, 1000ms);
+  auto options = Http::Options{}.hedgeDelay(50);
+  auto start = std::chrono::steady_clock::now();
+  auto res = client->get("/").options(options).send().get();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  ASSERT_TRUE(res.ok());
+  ASSERT_LT(elapsed, 1000ms);
+  ASSERT_EQ(server->nbConnections(), 2u);
+}
+
+TEST_F(HttpFixture, test_hedge_not_fired_on_fast_answer)
+{
+  auto options = Http::Options{}.hedgeDelay(500);
+  auto res = client->get("/").options(options).send().get();
+  ASSERT_TRUE(res.ok());
+  ASSERT_EQ(server->nbConnections(), 1u);
+}
+
+TEST_F(HttpFixture, test_load_balancing_ejects_failing_endpoint)
+{
+  auto options = Http::Options{}.loadBalancing(Http::LoadBalancing::RoundRobin).ejectAfter(1);
+  Http::Client balanced{std::vector<std::string>{"http://127.0.0.1:8281", "http://127.0.0.1:8282"}, options};
+  std::size_t nbOk = 0;
+  for (auto i = 0; i < 4; ++i)
+  {
+    if (balanced.get("/").send().get().ok()) ++nbOk;
+  }
+  ASSERT_EQ(nbOk, 3u);
+  ASSERT_EQ(server->nbConnections(), 3u);
+}
+
+TEST_F(HttpFixture, test_load_balancing_retries_on_other_endpoint)
+{
+  auto options = Http::Options{}
+    .loadBalancing(Http::LoadBalancing::LeastOutstanding)
+    .retryPolicy(Http::RetryPolicy{}.baseDelay(10));
+  Http::Client balanced{std::vector<std::string>{"http://127.0.0.1:8282", "http://127.0.0.1:8281"}, options};
+  for (auto i = 0; i < 4; ++i)
+  {
+    ASSERT_TRUE(balanced.get("/").send().get().ok());
+  }
+}
+
+TEST_F(HttpFixture, test_happy_eyeballs_skips_stalled_address)
+{
+  using boost::asio::ip::make_address;
+  boost::asio::io_context ioc;
+  Http::detail::HappyEyeballs::TEndpoints endpoints{{make_address("10.255.255.1"), 8281}, {make_address("127.0.0.1"), 8281}};
+  auto racer = std::make_shared<Http::detail::HappyEyeballs>(ioc.get_executor(), endpoints, 50ms);
+  std::optional<Http::detail::HappyEyeballs::TEndpoint> winner;
+  auto start = std::chrono::steady_clock::now();
+  boost::asio::post(ioc, [&] {
+    racer->start(5000ms, [&](const auto& ec, auto&&, const auto& endpoint) {
+      if (!ec) winner = endpoint;
+    });
+  });
+  ioc.run();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  ASSERT_TRUE(winner.has_value());
+  ASSERT_EQ(winner->address(), make_address("127.0.0.1"));
+  ASSERT_LT(elapsed, 1000ms);
+}
+
+TEST_F(HttpFixture, test_circuit_breaker_fails_fast_when_open)
+{
+  auto policy = Http::CircuitBreakerPolicy{}.minCalls(2).windowSize(2).openDuration(200);
+  Http::Client guarded{"http://127.0.0.1:8281", Http::Options{}.circuitBreaker(policy)};
+  server->failNext(2, http::status::internal_server_error);
+  ASSERT_EQ(guarded.get("/").send().get().status(), 500u);
+  ASSERT_EQ(guarded.get("/").send().get().status(), 500u);
+  ASSERT_EQ(guarded.get("/").send().get().status(), Http::StatusCircuitOpen);
+  ASSERT_EQ(guarded.get("/").options(Http::Options{}.hedgeDelay(10)).send().get().status(), Http::StatusCircuitOpen);
+  ASSERT_EQ(server->nbConnections(), 2u);
+  std::this_thread::sleep_for(250ms);
+  ASSERT_TRUE(guarded.get("/").send().get().ok());
+  ASSERT_TRUE(guarded.get("/").send().get().ok());
+  ASSERT_EQ(server->nbConnections(), 4u);
+}
+
+TEST_F(HttpFixture, test_rate_limiter_smooths_requests)
+{
+  Http::Client limited{"http://127.0.0.1:8281", Http::Options{}.maxRequestRate(20)};
+  std::vector<std::shared_future<Http::Response>> responses;
+  auto start = std::chrono::steady_clock::now();
+  for (auto i = 0; i < 25; ++i) responses.push_back(limited.get("/").send());
+  for (auto& res : responses) ASSERT_TRUE(res.get().ok());
+  ASSERT_GE(std::chrono::steady_clock::now() - start, 200ms);
+}
+
+TEST_F(HttpFixture, test_rate_limiter_fails_fast_when_queue_full)
+{
+  Http::Client limited{"http://127.0.0.1:8281", Http::Options{}.maxRequestRate(10).maxQueuedRequests(2)};
+  std::vector<std::shared_future<Http::Response>> responses;
+  for (auto i = 0; i < 13; ++i) responses.push_back(limited.get("/").send());
+  ASSERT_EQ(responses.back().get().status(), Http::StatusRateLimited);
+  for (auto i = 0; i < 12; ++i) ASSERT_TRUE(responses[i].get().ok());
+}
+
+TEST_F(HttpFixture, test_upload_throttled)
+{
+  std::string body(200000, 'x');
+  auto start = std::chrono::steady_clock::now();
+  auto res = client->post("/").body(body).options(Http::Options{}.maxUploadRate(400000)).send().get();
+  ASSERT_TRUE(res.ok());
+  ASSERT_GE(std::chrono::steady_clock::now() - start, 300ms);
+}
+
+TEST_F(HttpFixture, test_download_throttled)
+{
+  std::string body(200000, 'x');
+  Http::Client throttled{"http://127.0.0.1:8281", Http::Options{}.maxTotalDownloadRate(400000)};
+  auto start = std::chrono::steady_clock::now();
+  auto res = throttled.post("/").body(body).send().get();
+  ASSERT_TRUE(res.ok());
+  ASSERT_EQ(res.body().text().size(), body.size());
+  ASSERT_GE(std::chrono::steady_clock::now() - start, 300ms);
+}
+
+TEST_F(HttpFixture, test_cache_fresh_hit)
+{
+  Http::Client cached{"http://127.0.0.1:8281", Http::Options{}.cacheSize(1 << 20)};
+  ASSERT_EQ(cached.get("/cached").send().get().body().text(), "cached");
+  auto res = cached.get("/cached").send().get();
+  ASSERT_TRUE(res.ok());
+  ASSERT_EQ(res.body().text(), "cached");
+  ASSERT_EQ(res.header("ETag"), "\"v1\"");
+  ASSERT_EQ(server->nbConnections(), 1u);
+  ASSERT_EQ(cached.cacheStats().hits, 1u);
+  ASSERT_EQ(cached.cacheStats().misses, 1u);
+}
+
+TEST_F(HttpFixture, test_cache_revalidation)
+{
+  Http::Client cached{"http://127.0.0.1:8281", Http::Options{}.cacheSize(1 << 20)};
+  ASSERT_TRUE(cached.get("/cached?max-age=0").send().get().ok());
+  auto res = cached.get("/cached?max-age=0").send().get();
+  ASSERT_TRUE(res.ok());
+  ASSERT_EQ(res.body().text(), "cached");
+  ASSERT_EQ(server->nbConnections(), 2u);
+  ASSERT_EQ(cached.cacheStats().revalidations, 1u);
+}
+
+TEST_F(HttpFixture, test_disk_cache_survives_restart)
+{
+  auto dir = fs::temp_directory_path() / "http_disk_cache_test";
+  fs::remove_all(dir);
+  {
+    Http::Client cached{"http://127.0.0.1:8281", Http::Options{}.cacheDir(dir)};
+    auto res = cached.get("/cached?binary").send().get();
+    ASSERT_TRUE(res.body().isBinary());
+  }
+  Http::Client cached{"http://127.0.0.1:8281", Http::Options{}.cacheDir(dir)};
+  auto res = cached.get("/cached?binary").send().get();
+  ASSERT_TRUE(res.ok());
+  ASSERT_TRUE(res.body().isBinary());
+  auto const& binary = res.body().binary();
+  ASSERT_EQ(std::string(reinterpret_cast<const char*>(binary.data()), binary.size()), "cached");
+  ASSERT_EQ(server->nbConnections(), 1u);
+  ASSERT_EQ(cached.cacheStats().hits, 1u);
+  fs::remove_all(dir);
+}
+
+TEST_F(HttpFixture, test_single_flight_coalesces_identical_gets)
+{
+  server->delayNext(1, 300ms);
+  auto options = Http::Options{}.singleFlight(true);
+  std::vector<std::shared_future<Http::Response>> responses;
+  for (auto i = 0; i < 5; ++i) responses.push_back(client->get("/").options(options).send());
+  for (auto& res : responses) ASSERT_TRUE(res.get().ok());
+  ASSERT_EQ(server->nbConnections(), 1u);
+}
+
+TEST_F(HttpFixture, test_resume_download)
+{
+  auto path = fs::temp_directory_path() / "http_resume_test";
+  auto expected = EchoServer::fileContent();
+  {
+    std::ofstream partial{path, std::ios::binary | std::ios::trunc};
+    partial << expected.substr(0, 30000);
+  }
+  auto res = client->get("/file").options(Http::Options{}.fileOut(path).resume(true)).send().get();
+  ASSERT_TRUE(res.ok());
+  std::ifstream file{path, std::ios::binary};
+  std::string content{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+  ASSERT_EQ(content, expected);
+  fs::remove(path);
+}
+
+TEST_F(HttpFixture, test_parallel_ranged_download)
+{
+  auto path = fs::temp_directory_path() / "http_parallel_test";
+  fs::remove(path);
+  auto res = client->get("/file").options(Http::Options{}.fileOut(path).parallelRanges(4)).send().get();
+  ASSERT_TRUE(res.ok());
+  std::ifstream file{path, std::ios::binary};
+  std::string content{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+  ASSERT_EQ(content, EchoServer::fileContent());
+  ASSERT_EQ(server->nbConnections(), 5u);
+  fs::remove(path);
+}
+
+TEST_F(HttpFixture, test_chunked_upload)
+{
+  auto path = fs::temp_directory_path() / "http_chunked_upload_test";
+  {
+    std::ofstream file{path, std::ios::binary};
+    file << EchoServer::fileContent();
+  }
+  std::atomic<std::size_t> sent{0};
+  auto upload = Http::ChunkedUpload{}.chunkSize(16384).parallelism(3).progress([&sent](std::size_t, std::size_t processed) { sent = processed; });
+  auto res = client->upload("/upload", path, upload).get();
+  ASSERT_TRUE(res.ok());
+  ASSERT_EQ(res.body().text(), "ok");
+  ASSERT_EQ(server->nbConnections(), 5u);
+  ASSERT_EQ(sent, EchoServer::fileContent().size());
+  fs::remove(path);
+}
+
+TEST_F(HttpFixture, test_upload_memory_mapped_file)
+{
+  auto path = fs::temp_directory_path() / "http_mmap_test.json";
+  {
+    std::ofstream file{path, std::ios::binary};
+    file << nlohmann::json(EchoServer::fileContent()).dump();
+  }
+  auto res = client->post("/").body(path).options(Http::Options{}.memoryMap(true).readBufferSize(4096)).send().get();
+  ASSERT_TRUE(res.ok());
+  ASSERT_EQ(res.body().json(), EchoServer::fileContent());
+  fs::remove(path);
+}
+
+TEST_F(HttpFixture, test_atomic_file_download)
+{
+  auto dir = fs::temp_directory_path() / "http_atomic_test";
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+  auto path = dir / "file";
+  auto res = client->get("/file").options(Http::Options{}.fileOut(path).atomicFileOut(true)).send().get();
+  ASSERT_TRUE(res.ok());
+  ASSERT_EQ(res.body().path(), path);
+  ASSERT_EQ(std::distance(fs::directory_iterator{dir}, fs::directory_iterator{}), 1);
+  std::ifstream file{path, std::ios::binary};
+  std::string content{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+  ASSERT_EQ(content, EchoServer::fileContent());
+  file.close();
+  fs::remove_all(dir);
+}
+
+TEST_F(HttpFixture, test_small_binary_response_in_memory)
+{
+  auto res = client->get("/file").options(Http::Options{}.range({0, 9})).send().get();
+  ASSERT_EQ(res.status(), 206u);
+  ASSERT_TRUE(res.body().isBinary());
+  auto const& binary = res.body().binary();
+  ASSERT_EQ(std::string(reinterpret_cast<const char*>(binary.data()), binary.size()), EchoServer::fileContent().substr(0, 10));
+
+  auto large = client->get("/file").send().get();
+  ASSERT_TRUE(large.body().isPath());
+  fs::remove(large.body().path());
+}
+
+TEST_F(HttpFixture, test_post_binary_views)
+{
+  const std::array<std::uint8_t, 4> borrowed{0x00, 0xff, 0x10, 0x80};
+  auto res = client->post("/").body(Http::BinaryView{borrowed.data(), borrowed.size()}).send().get();
+  ASSERT_TRUE(res.ok());
+  ASSERT_TRUE(res.body().isBinary());
+  ASSERT_EQ(res.body().binary().size(), borrowed.size());
+  ASSERT_EQ(std::memcmp(res.body().binary().data(), borrowed.data(), borrowed.size()), 0);
+
+  auto shared = std::make_shared<std::string>("shared bytes");
+  res = client->post("/").body(Http::BinaryView{shared}).send().get();
+  ASSERT_TRUE(res.ok());
+  ASSERT_EQ(std::string(reinterpret_cast<const char*>(res.body().binary().data()), res.body().binary().size()), *shared);
+}
+
+TEST_F(HttpFixture, test_json_body_serialized_once_per_content)
+{
+  auto request = client->post("/");
+  request.body(nlohmann::json{{"name", "captain"}});
+  auto first = request.send().get();
+  auto second = request.send().get();
+  ASSERT_EQ(first.body().json(), second.body().json());
+
+  request.body(nlohmann::json{{"name", "pirate"}});
+  auto third = request.send().get();
+  ASSERT_EQ(third.body().json()["name"], "pirate");
+}
+
+TEST_F(HttpFixture, test_lazy_json_response)
+{
+  Person body{"captain", 42};
+  auto res = client->post("/").body(body).send().get();
+  ASSERT_TRUE(res.body().isJson());
+  auto const& lazy = std::get<Http::LazyJson>(res.body().content());
+  ASSERT_FALSE(lazy.isParsed());
+  ASSERT_EQ(nlohmann::json::parse(res.body().raw()), nlohmann::json(body));
+
+  // Forwarding the payload doesn't parse it
+  auto forwarded = client->post("/").body(lazy).send().get();
+  ASSERT_FALSE(lazy.isParsed());
+  ASSERT_EQ(forwarded.body().raw(), res.body().raw());
+
+  ASSERT_EQ(res.body().get<Person>(), body);
+  ASSERT_TRUE(lazy.isParsed());
+}
+
+TEST_F(HttpFixture, test_large_body_read_in_place)
+{
+  std::string text(512 * 1024 + 7, '\0');
+  for (std::size_t i = 0; i < text.size(); ++i) text[i] = static_cast<char>('a' + i % 26);
+  auto res = client->post("/").body(text).send().get();
+  ASSERT_TRUE(res.ok());
+  ASSERT_EQ(res.body().text(), text);
+
+  auto bytes = std::make_shared<Http::TBinary>(300000);
+  for (std::size_t i = 0; i < bytes->size(); ++i) (*bytes)[i] = static_cast<std::byte>(i % 251);
+  res = client->post("/").body(Http::BinaryView{bytes}).options(Http::Options{}.memoryBodyLimit(1024 * 1024)).send().get();
+  ASSERT_TRUE(res.ok());
+  ASSERT_TRUE(res.body().isBinary());
+  ASSERT_EQ(res.body().binary(), *bytes);
+}
+
+TEST_F(HttpFixture, test_arena_blocks_reused_across_sessions)
+{
+  auto pool = std::make_shared<Http::detail::ArenaPool>();
+  auto fill = [&pool]() {
+    auto arena = std::make_shared<Http::detail::Arena>(pool);
+    Http::detail::TFields fields{Http::detail::TFieldsAllocator{arena}};
+    for (int i = 0; i < 64; ++i) fields.set("X-Header-" + std::to_string(i), std::string(100, 'x'));
+    return fields[std::string("X-Header-63")].size();
+  };
+
+  ASSERT_EQ(fill(), 100u);
+  auto allocated = pool->allocated();
+  ASSERT_GT(allocated, 1u);
+  for (int i = 0; i < 10; ++i) ASSERT_EQ(fill(), 100u);
+  ASSERT_EQ(pool->allocated(), allocated);
+
+  auto send = [this]() {
+    return client->post("/").header("X-Arena", std::string(100, 'x')).body(std::string("arena")).send().get().body().text();
+  };
+  ASSERT_EQ(send(), "arena");
+  auto blocks = client->arenaBlocks();
+  ASSERT_GT(blocks, 0u);
+  // A session may still be giving its arena back while the next one starts, but no more than that
+  for (int i = 0; i < 10; ++i) ASSERT_EQ(send(), "arena");
+  ASSERT_LE(client->arenaBlocks(), 2 * blocks);
+}
+
+TEST_F(HttpFixture, test_buffers_recycled_through_pool)
+{
+  auto& pool = Http::detail::BufferPool::instance();
+  ASSERT_EQ(Http::detail::BufferPool::capacity(5000), 8192u);
+
+  auto first = pool.acquire(64 * 1024);
+  pool.release(first, 64 * 1024);
+  auto allocated = pool.allocated();
+  auto second = pool.acquire(60 * 1024);
+  ASSERT_EQ(first, second);
+  ASSERT_EQ(pool.allocated(), allocated);
+  pool.release(second, 60 * 1024);
+
+  {
+    Http::detail::PooledBuffer buffer{Http::Options::DefaultBufferSize};
+    ASSERT_EQ(static_cast<void*>(buffer.data()), first);
+  }
+
+  auto path = fs::temp_directory_path() / "http_pooled_test.json";
+  {
+    std::ofstream file{path, std::ios::binary};
+    file << nlohmann::json(EchoServer::fileContent()).dump();
+  }
+  auto res = client->post("/").body(path).send().get();
+  ASSERT_TRUE(res.ok());
+  ASSERT_EQ(res.body().json(), EchoServer::fileContent());
+  fs::remove(path);
+}
+
+TEST_F(HttpFixture, test_prepared_request)
+{
+  auto request = client->post("/").header("X-Static", "1").prepare();
+  request.header("X-Trace", "first");
+  request.body(nlohmann::json{{"name", "captain"}});
+  auto first = request.send().get();
+  ASSERT_TRUE(first.ok());
+  ASSERT_EQ(first.body().json()["name"], "captain");
+
+  request.header("X-Trace", "second").body(std::string("pirate"));
+  auto second = request.send().get();
+  ASSERT_TRUE(second.ok());
+  ASSERT_EQ(second.body().text(), "pirate");
+
+  auto ranged = client->get("/file").prepare().options(Http::Options{}.range({0, 9}));
+  auto res = ranged.send().get();
+  ASSERT_EQ(res.status(), 206u);
+  ASSERT_EQ(res.body().binary().size(), 10u);
+  res = ranged.send().get();
+  ASSERT_EQ(res.status(), 206u);
+}
+
+TEST_F(HttpFixture, test_multipart_body_gathered)
+{
+  auto path = fs::temp_directory_path() / "http_gathered_test.txt";
+  {
+    std::ofstream file{path, std::ios::binary};
+    file << EchoServer::fileContent();
+  }
+  Http::FormData form;
+  form.add("name", "captain");
+  form.add("file", "first.txt", path);
+  form.add("file", "second.txt", path, 0, 100);
+
+  Http::detail::TFormRequest request{boost::beast::http::verb::post, "/", 11};
+  Http::detail::FormDataBody::writer writer{request.base(), form};
+  writer.buffer_size(4096);
+  boost::beast::error_code ec;
+  writer.init(ec);
+
+  std::string sent;
+  std::size_t gets = 0;
+  for (bool more = true; more; ++gets)
+  {
+    auto result = writer.get(ec);
+    ASSERT_FALSE(ec);
+    ASSERT_TRUE(result.has_value());
+    for (auto buffer : boost::beast::buffers_range_ref(result->first)) sent.append(static_cast<const char*>(buffer.data()), buffer.size());
+    more = result->second;
+  }
+
+  // Each get carries one file chunk along with the surrounding parameters, part headers and boundaries
+  auto chunks = (EchoServer::fileContent().size() + 4095) / 4096 + 1;
+  ASSERT_EQ(gets, chunks);
+  ASSERT_EQ(sent.size(), form.size());
+  ASSERT_NE(sent.find(EchoServer::fileContent()), std::string::npos);
+  ASSERT_EQ(sent.substr(sent.size() - form.boundary().size() - 6), "--" + form.boundary() + "--\r\n");
+
+  auto res = client->post("/").body(form).prepare().send().get();
+  ASSERT_TRUE(res.ok());
+  ASSERT_EQ(res.body().text(), "ok");
+  fs::remove(path);
+}
+
+TEST_F(HttpFixture, test_failed_parallel_download_not_resumed_as_complete)
+{
+  auto path = fs::temp_directory_path() / "http_parallel_failure_test";
+  fs::remove(path);
+  server->failNext(1, http::status::internal_server_error, {}, 2);
+  auto res = client->get("/file").options(Http::Options{}.fileOut(path).parallelRanges(4)).send().get();
+  ASSERT_EQ(res.status(), 500u);
+  ASSERT_FALSE(fs::exists(path));
+
+  // A leftover preallocated file is downloaded again rather than reported complete
+  std::ofstream{path};
+  fs::resize_file(path, EchoServer::fileContent().size());
+  std::ofstream{fs::path(path.string() + ".ranges")};
+  res = client->get("/file").options(Http::Options{}.fileOut(path).resume(true)).send().get();
+  ASSERT_TRUE(res.ok());
+  std::ifstream file{path, std::ios::binary};
+  std::string content{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+  ASSERT_EQ(content, EchoServer::fileContent());
+  ASSERT_FALSE(fs::exists(path.string() + ".ranges"));
+  fs::remove(path);
+}
+
+TEST_F(HttpFixture, test_prepared_request_headers_not_duplicated)
+{
+  auto count = [](const std::string& text, const std::string& line) {
+    std::size_t n = 0;
+    for (auto pos = text.find(line); pos != std::string::npos; pos = text.find(line, pos + 1)) ++n;
+    return n;
+  };
+
+  auto request = client->post("/headers").header("User-Agent", "captain").header("Content-Type", "text").prepare();
+  request.body(std::string("pirate"));
+  auto res = request.send().get();
+  ASSERT_TRUE(res.ok());
+  auto headers = res.body().text();
+  ASSERT_EQ(count(headers, "User-Agent: "), 1u);
+  ASSERT_EQ(count(headers, "User-Agent: captain"), 1u);
+  ASSERT_EQ(count(headers, "Content-Type: "), 1u);
+  ASSERT_EQ(count(headers, "Host: "), 1u);
+
+  request.header("host", "example.com");
+  res = request.send().get();
+  ASSERT_TRUE(res.ok());
+  headers = res.body().text();
+  ASSERT_EQ(count(headers, "Host: ") + count(headers, "host: "), 1u);
+  ASSERT_EQ(count(headers, "host: example.com"), 1u);
+}
+
+TEST_F(HttpFixture, test_disk_cache_hits_copied_to_file_out)
+{
+  auto dir = fs::temp_directory_path() / "http_disk_cache_copy_test";
+  auto first = fs::temp_directory_path() / "http_disk_cache_first";
+  auto second = fs::temp_directory_path() / "http_disk_cache_second";
+  fs::remove_all(dir);
+  Http::Client cached{"http://127.0.0.1:8281", Http::Options{}.cacheDir(dir)};
+  for (auto const& target : {std::string{"/cached?binary"}, std::string{"/cached?binary&max-age=0"}})
+  {
+    ASSERT_TRUE(cached.get(target).options(Http::Options{}.fileOut(first)).send().get().ok());
+    std::ofstream{first, std::ios::trunc} << "overwritten";
+    auto res = cached.get(target).options(Http::Options{}.fileOut(second)).send().get();
+    ASSERT_TRUE(res.ok());
+    ASSERT_EQ(res.body().path(), second);
+    std::ifstream file{second};
+    std::string content{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    ASSERT_EQ(content, "cached");
+  }
+  ASSERT_EQ(cached.cacheStats().hits, 1u);
+  ASSERT_EQ(cached.cacheStats().revalidations, 1u);
+  fs::remove(first);
+  fs::remove(second);
+  fs::remove_all(dir);
+}
+
+TEST_F(HttpFixture, test_cache_keyed_by_credentials_and_vary)
+{
+  Http::Client cached{"http://127.0.0.1:8281", Http::Options{}.cacheSize(1 << 20)};
+  auto alice = Http::Options{}.auth("Bearer alice");
+  ASSERT_TRUE(cached.get("/cached").options(alice).send().get().ok());
+  ASSERT_TRUE(cached.get("/cached").options(alice).send().get().ok());
+  ASSERT_EQ(cached.cacheStats().hits, 0u);
+
+  ASSERT_TRUE(cached.get("/cached?public").options(alice).send().get().ok());
+  ASSERT_TRUE(cached.get("/cached?public").options(alice).send().get().ok());
+  ASSERT_EQ(cached.cacheStats().hits, 1u);
+  ASSERT_TRUE(cached.get("/cached?public").options(Http::Options{}.auth("Bearer bob")).send().get().ok());
+  ASSERT_EQ(cached.cacheStats().hits, 1u);
+
+  ASSERT_TRUE(cached.get("/cached?vary").header("Accept-Language", "fr").send().get().ok());
+  ASSERT_TRUE(cached.get("/cached?vary").header("Accept-Language", "fr").send().get().ok());
+  ASSERT_EQ(cached.cacheStats().hits, 2u);
+  ASSERT_TRUE(cached.get("/cached?vary").header("Accept-Language", "en").send().get().ok());
+  ASSERT_EQ(cached.cacheStats().hits, 2u);
+
+  ASSERT_TRUE(cached.get("/cached").send().get().ok());
+  ASSERT_TRUE(cached.get("/cached").options(Http::Options{}.range({0, 1})).send().get().ok());
+  ASSERT_EQ(cached.cacheStats().hits, 2u);
+}
+
+TEST_F(HttpFixture, test_single_flight_canceled_leader_hands_over)
+{
+  server->delayNext(1, 300ms);
+  auto options = Http::Options{}.singleFlight(true);
+  auto leader = client->get("/");
+  leader.options(options);
+  auto first = leader.send();
+  auto second = client->get("/").options(options).send();
+  auto third = client->get("/").options(options).send();
+  server->waitDelayed();
+  leader.cancel();
+  ASSERT_EQ(first.get().status(), Http::StatusCanceled);
+  ASSERT_TRUE(second.get().ok());
+  ASSERT_TRUE(third.get().ok());
+  ASSERT_EQ(server->nbConnections(), 2u);
+}
+
+TEST_F(HttpFixture, test_single_flight_keyed_by_range)
+{
+  server->delayNext(1, 300ms);
+  auto options = Http::Options{}.singleFlight(true);
+  auto whole = client->get("/file").options(options).send();
+  auto head = client->get("/file").options(Http::Options{options}.range({0, 9})).send();
+  ASSERT_EQ(whole.get().status(), 200u);
+  ASSERT_EQ(head.get().status(), 206u);
+  ASSERT_EQ(server->nbConnections(), 2u);
+}
+
+TEST_F(HttpFixture, test_chunked_upload_failures)
+{
+  auto path = fs::temp_directory_path() / "http_chunked_upload_failure_test";
+  {
+    std::ofstream file{path, std::ios::binary};
+    file << EchoServer::fileContent();
+  }
+  server->failNext(1, http::status::bad_request);
+  auto res = client->upload("/upload", path, Http::ChunkedUpload{}.chunkSize(16384).parallelism(1)).get();
+  ASSERT_EQ(res.status(), 400u);
+  ASSERT_EQ(server->nbConnections(), 1u);
+
+  auto truncate = Http::ChunkedUpload{}.chunkSize(16384).parallelism(1).progress([&path](std::size_t, std::size_t) { fs::resize_file(path, 0); });
+  res = client->upload("/upload", path, truncate).get();
+  ASSERT_FALSE(res.ok());
+  ASSERT_NE(res.reason().find("Failed to upload"), std::string::npos);
+  fs::remove(path);
+}
+
+TEST_F(HttpFixture, test_body_replaced_while_sending)
+{
+  auto const body = std::string(256 << 10, 'x');
+  auto req = client->post("/");
+  req.body(body);
+  std::atomic<bool> replaced{false};
+  req.options(Http::Options{}.maxUploadRate(1 << 20).sendProgress([&req, &replaced](std::size_t, std::size_t) {
+    if (false == replaced.exchange(true)) req.body(std::string(16, 'y'));
+  }));
+  auto res = req.send().get();
+  ASSERT_TRUE(res.ok());
+  ASSERT_EQ(res.body().text(), body);
+}
+
+TEST_F(HttpFixture, test_canceled_calls_not_counted_by_circuit_breaker)
+{
+  auto policy = Http::CircuitBreakerPolicy{}.minCalls(2).windowSize(2).failureRatio(1.0).openDuration(1000);
+  Http::Client guarded{"http://127.0.0.1:8281", Http::Options{}.circuitBreaker(policy)};
+  server->failNext(1, http::status::internal_server_error);
+  ASSERT_EQ(guarded.get("/").send().get().status(), 500u);
+  server->delayNext(1, 300ms);
+  auto canceled = guarded.get("/");
+  auto res = canceled.send();
+  server->waitDelayed();
+  canceled.cancel();
+  ASSERT_EQ(res.get().status(), Http::StatusCanceled);
+  server->waitIdle();
+  server->failNext(1, http::status::internal_server_error);
+  ASSERT_EQ(guarded.get("/").send().get().status(), 500u);
+  ASSERT_EQ(guarded.get("/").send().get().status(), Http::StatusCircuitOpen);
+}
+
+TEST_F(HttpFixture, test_prepared_request_streams_large_body)
+{
+  auto path = fs::temp_directory_path() / "http_prepared_stream_test.json";
+  {
+    std::ofstream file{path, std::ios::binary};
+    file << nlohmann::json(EchoServer::fileContent()).dump();
+  }
+  std::atomic<std::size_t> writes{0};
+  auto options = Http::Options{}.memoryMap(true).writeBufferSize(4096).sendProgress([&writes](std::size_t, std::size_t) { ++writes; }, 0.0);
+  auto res = client->post("/").prepare().body(path).options(options).send().get();
+  ASSERT_TRUE(res.ok());
+  ASSERT_EQ(res.body().json(), EchoServer::fileContent());
+  ASSERT_GT(writes, 1u);
+  fs::remove(path);
+}
+
+TEST_F(HttpFixture, test_chunked_upload_retries_failed_chunk)
+{
+  auto path = fs::temp_directory_path() / "http_chunked_upload_retry_test";
+  {
+    std::ofstream file{path, std::ios::binary};
+    file << EchoServer::fileContent();
+  }
+  server->failNext(1, http::status::service_unavailable);
+  auto res = client->upload("/upload", path, Http::ChunkedUpload{}.chunkSize(16384).parallelism(1)).get();
+  ASSERT_TRUE(res.ok());
+  ASSERT_EQ(res.body().text(), "ok");
+  ASSERT_EQ(server->nbConnections(), 6u);
+  fs::remove(path);
+}
+
+TEST_F(HttpFixture, test_hedged_get_failure_does_not_hide_success)
+{
+  server->delayNext(1, 300ms);
+  server->failNext(1, http::status::service_unavailable);
+  auto res = client->get("/").options(Http::Options{}.hedgeDelay(50)).send().get();
+  ASSERT_TRUE(res.ok());
+  ASSERT_EQ(server->nbConnections(), 2u);
+}
+
+TEST_F(HttpFixture, test_single_flight_keyed_by_credentials)
+{
+  server->delayNext(1, 300ms);
+  auto options = Http::Options{}.singleFlight(true).singleFlightHeaders({"Accept"});
+  auto alice = client->get("/").header("Authorization", "Bearer alice").options(options).send();
+  auto bob = client->get("/").header("Authorization", "Bearer bob").options(options).send();
+  ASSERT_TRUE(alice.get().ok());
+  ASSERT_TRUE(bob.get().ok());
+  ASSERT_EQ(server->nbConnections(), 2u);
+}
+
+TEST_F(HttpFixture, test_parallel_download_canceled_through_request)
+{
+  auto path = fs::temp_directory_path() / "http_parallel_cancel_test";
+  fs::remove(path);
+  server->delayNext(3, 300ms);
+  auto request = client->get("/file");
+  std::atomic<bool> canceled{false};
+  auto cancel = [&request, &canceled](std::size_t, std::size_t total) { if (total > 1 && false == canceled.exchange(true)) request.cancel(); };
+  request.options(Http::Options{}.fileOut(path).parallelRanges(4).recvProgress(cancel));
+  auto res = request.send().get();
+  ASSERT_EQ(res.status(), Http::StatusCanceled);
+  ASSERT_FALSE(fs::exists(path));
+}
+
+TEST_F(HttpFixture, test_set_cookie_headers_not_folded)
+{
+  Http::Client cached{"http://127.0.0.1:8281", Http::Options{}.cacheSize(1 << 20)};
+  auto expected = std::string("a=1; Expires=Wed, 21 Oct 2026 07:28:00 GMT\nb=2");
+  ASSERT_EQ(cached.get("/cached?cookies").send().get().header("Set-Cookie"), expected);
+  ASSERT_EQ(cached.get("/cached?cookies").send().get().header("Set-Cookie"), expected);
+  ASSERT_EQ(cached.cacheStats().hits, 1u);
+}